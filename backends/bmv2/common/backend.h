@@ -69,7 +69,11 @@ class Backend {
           json(new BMV2::JsonObjects()) {
         refMap->setIsV1(options.isv1());
     }
-    void serialize(std::ostream &out) const { json->toplevel->serialize(out); }
+    void serialize(std::ostream &out) const {
+        Util::JsonWriter writer(out, options.compactJson ? Util::JsonWriter::Style::Compact
+                                                         : Util::JsonWriter::Style::Pretty);
+        writer.value(json->toplevel);
+    }
     virtual void convert(const IR::ToplevelBlock *block) = 0;
 };
 
@@ -23,6 +23,8 @@ class BMV2Options : public CompilerOptions {
     std::filesystem::path outputFile;
     /// Read from json.
     bool loadIRFromJson = false;
+    /// Write the output json without whitespace.
+    bool compactJson = false;
 
     BMV2Options() {
         registerOption(
@@ -49,6 +51,13 @@ class BMV2Options : public CompilerOptions {
             },
             "Use IR representation from JsonFile dumped previously,"
             "the compilation starts with reduced midEnd.");
+        registerOption(
+            "--compact-json", nullptr,
+            [this](const char *) {
+                compactJson = true;
+                return true;
+            },
+            "[BMv2 back-end] Write the output json without indentation or line breaks.");
     }
 };
 
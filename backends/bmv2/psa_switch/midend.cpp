@@ -35,6 +35,7 @@
 #include "midend/flattenHeaders.h"
 #include "midend/flattenInterfaceStructs.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeTables.h"
 #include "midend/midEndLast.h"
 #include "midend/nestedStructs.h"
 #include "midend/orderArguments.h"
@@ -148,6 +149,7 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStre
                 "psa_idle_timeout"_cs,
                 "size"_cs,
             }),
+            options.mergeTables ? new P4::MergeTables(&typeMap) : nullptr,
             new P4::SimplifyControlFlow(&typeMap, true),
             new P4::CompileTimeOperations(),
             new P4::TableHit(&typeMap),
@@ -38,6 +38,7 @@
 #include "midend/flattenHeaders.h"
 #include "midend/flattenInterfaceStructs.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeTables.h"
 #include "midend/midEndLast.h"
 #include "midend/nestedStructs.h"
 #include "midend/orderArguments.h"
@@ -115,6 +116,7 @@ SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions &options, std::ostream *o
                  "meters"_cs,
                  "support_timeout"_cs,
              }),
+             options.mergeTables ? new P4::MergeTables(&typeMap) : nullptr,
              new P4::SimplifyControlFlow(&typeMap, true),
              new P4::EliminateTypedef(&typeMap),
              new P4::CompileTimeOperations(),
@@ -8,6 +8,7 @@
 
 #include "../bmv2/common/lower.h"
 #include "dpdkArch.h"
+#include "dpdkAsmCfgOpt.h"
 #include "dpdkAsmOpt.h"
 #include "dpdkCheckExternInvocation.h"
 #include "dpdkContext.h"
@@ -71,6 +72,7 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new ConvertToDpdkArch(refMap, &structure),
         new InjectJumboStruct(&structure),
         new InjectFixedMetadataField(&structure),
+        options.optimizationLevel >= 2 ? new ReorderMetadataForTableKeys(&structure) : nullptr,
         new P4::ClearTypeMap(typeMap),
         new P4::TypeChecking(refMap, typeMap, true),
         new P4::ResolveReferences(refMap),
@@ -140,6 +142,9 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new EliminateUnusedAction(),
         new DpdkAsmOptimization,
         new CopyPropagationAndElimination(typeMap),
+    });
+    if (options.optimizationLevel >= 2) postCodeGen.addPasses({new DpdkAsmCfgOptimization});
+    postCodeGen.addPasses({
         new CollectUsedMetadataField(usedFields),
         new RemoveUnusedMetadataFields(usedFields),
         new ShortenTokenLength(newNameMap),
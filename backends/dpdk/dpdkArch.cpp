@@ -11,6 +11,9 @@
 
 #include "dpdkArch.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "dpdkHelpers.h"
 #include "dpdkUtils.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -684,6 +687,219 @@ const IR::Node *InjectFixedMetadataField::preorder(IR::Type_Struct *s) {
     return s;
 }
 
+/// @returns the width in bits used by getFieldBitOffset for a metadata field of
+/// type @p type, or -1 if it is not known here.
+static int metadataFieldWidth(const IR::Type *type) {
+    if (type->is<IR::Type_Bits>() || type->is<IR::Type_Boolean>()) return type->width_bits();
+    return -1;
+}
+
+bool ReorderMetadataForTableKeys::isLearnerTable(const IR::P4Table *t) {
+    auto add_on_miss = t->properties->getProperty("add_on_miss");
+    if (add_on_miss == nullptr) return false;
+    auto value = add_on_miss->value->to<IR::ExpressionValue>();
+    if (value == nullptr) return false;
+    auto lit = value->expression->to<IR::BoolLiteral>();
+    return lit && lit->value;
+}
+
+bool ReorderMetadataForTableKeys::collectKey(const IR::P4Table *table,
+                                             const IR::Type_Struct *metadata, cstring metaParam,
+                                             TableKey &key) {
+    auto keys = table->getKey();
+    if (keys == nullptr) return false;
+    for (auto ke : keys->keyElements) {
+        if (ke->matchType->toString() != "exact") return false;
+        // Metadata fields are of the form <metaParam>.<fieldname> after ConvertToDpdkArch.
+        auto mem = ke->expression->to<IR::Member>();
+        if (mem == nullptr) return false;
+        auto pe = mem->expr->to<IR::PathExpression>();
+        if (pe == nullptr || pe->path->name != metaParam) return false;
+        auto field = metadata->getField(mem->member);
+        if (field == nullptr || !field->type->is<IR::Type_Bits>()) return false;
+        if (fixedFields.count(field->name.name)) return false;
+        if (std::find(key.fields.begin(), key.fields.end(), field->name.name) != key.fields.end())
+            return false;
+        key.fields.push_back(field->name.name);
+    }
+    // A single field is always contiguous.
+    if (key.fields.size() < 2) return false;
+    key.table = table;
+    // Same condition as in CopyMatchKeysToSingleStruct; other non-contiguous
+    // exact keys turn the table into a wildcard table.
+    key.copied = isLearnerTable(table) || key.fields.size() <= 5;
+    return true;
+}
+
+bool ReorderMetadataForTableKeys::isContiguous(const TableKey &key,
+                                               const IR::IndexedVector<IR::StructField> &fields) {
+    int offset = 0;
+    int start = INT_MAX;
+    int end = 0;
+    int size = 0;
+    for (auto f : fields) {
+        int width = metadataFieldWidth(f->type);
+        if (std::find(key.fields.begin(), key.fields.end(), f->name.name) != key.fields.end()) {
+            start = std::min(start, offset);
+            end = std::max(end, offset + width);
+            size += width;
+        }
+        offset += width;
+    }
+    return end - start <= size;
+}
+
+IR::IndexedVector<IR::StructField> ReorderMetadataForTableKeys::layout(
+    const IR::Type_Struct *metadata, const std::vector<TableKey> &keys) const {
+    // Chains of fields which are laid out next to each other, in this order.
+    std::vector<std::vector<cstring>> chains;
+    std::map<cstring, size_t> chainOf;
+    for (auto &key : keys) {
+        std::vector<cstring> placed;
+        std::vector<cstring> unplaced;
+        for (auto f : key.fields) (chainOf.count(f) ? placed : unplaced).push_back(f);
+        if (placed.empty()) {
+            for (auto f : key.fields) chainOf.emplace(f, chains.size());
+            chains.push_back(key.fields);
+            continue;
+        }
+        size_t c = chainOf.at(placed.front());
+        if (!std::all_of(placed.begin(), placed.end(),
+                         [&](cstring f) { return chainOf.at(f) == c; }))
+            continue;
+        auto &chain = chains[c];
+        size_t first = chain.size();
+        size_t last = 0;
+        for (size_t i = 0; i < chain.size(); i++) {
+            if (std::find(placed.begin(), placed.end(), chain[i]) == placed.end()) continue;
+            first = std::min(first, i);
+            last = std::max(last, i);
+        }
+        // The fields already placed must be adjacent, and the others can only
+        // be added at either end of the chain.
+        if (last - first + 1 != placed.size() || unplaced.empty()) continue;
+        if (last == chain.size() - 1) {
+            chain.insert(chain.end(), unplaced.begin(), unplaced.end());
+        } else if (first == 0) {
+            chain.insert(chain.begin(), unplaced.begin(), unplaced.end());
+        } else {
+            LOG3("Key of table " << key.table->name << " conflicts with the metadata layout");
+            continue;
+        }
+        for (auto f : unplaced) chainOf.emplace(f, c);
+    }
+
+    // Each chain takes the place of its first field in the original layout.
+    std::vector<const IR::StructField *> movable;
+    std::set<size_t> emitted;
+    for (auto f : metadata->fields) {
+        if (fixedFields.count(f->name.name)) continue;
+        auto it = chainOf.find(f->name.name);
+        if (it == chainOf.end()) {
+            movable.push_back(f);
+        } else if (emitted.insert(it->second).second) {
+            for (auto name : chains[it->second]) movable.push_back(metadata->getField(name));
+        }
+    }
+    // The fixed fields keep their index; the others fill the remaining places.
+    IR::IndexedVector<IR::StructField> fields;
+    auto next = movable.begin();
+    for (auto f : metadata->fields) fields.push_back(fixedFields.count(f->name.name) ? f : *next++);
+    return fields;
+}
+
+const IR::Node *ReorderMetadataForTableKeys::preorder(IR::P4Program *p) {
+    prune();
+    size_t index = 0;
+    const IR::Type_Struct *metadata = nullptr;
+    for (; index < p->objects.size(); index++) {
+        auto s = p->objects.at(index)->to<IR::Type_Struct>();
+        if (s && s->name == structure->local_metadata_type) {
+            metadata = s;
+            break;
+        }
+    }
+    if (metadata == nullptr) return p;
+    for (auto f : metadata->fields)
+        if (metadataFieldWidth(f->type) < 0) return p;
+
+    // The fields of the architecture metadata, named as in CollectMetadataHeaderInfo,
+    // and those injected by InjectFixedMetadataField.
+    fixedFields = {cstring(PnaMainOutputMetadataOutputPortName),
+                   cstring(DirectResourceTableEntryIndex)};
+    for (auto obj : p->objects) {
+        auto s = obj->to<IR::Type_Struct>();
+        if (s == nullptr || !isStandardMetadata(s->name.name)) continue;
+        for (auto field : s->fields)
+            fixedFields.insert(TypeStruct2Name(s->name.name) + "_" + field->name.name);
+    }
+
+    std::vector<TableKey> keys;
+    for (auto obj : p->objects) {
+        auto control = obj->to<IR::P4Control>();
+        if (control == nullptr) continue;
+        // The parameter of the local metadata type, see ConvertToDpdkArch.
+        cstring metaParam;
+        for (auto param : control->getApplyParameters()->parameters) {
+            auto tn = param->type->to<IR::Type_Name>();
+            if (tn && tn->path->name == structure->local_metadata_type) metaParam = param->name;
+        }
+        if (metaParam.isNullOrEmpty()) continue;
+        std::map<cstring, unsigned> applies;
+        forAllMatching<IR::MethodCallExpression>(
+            control->body, [&](const IR::MethodCallExpression *mce) {
+                auto mem = mce->method->to<IR::Member>();
+                if (mem == nullptr || mem->member != IR::IApply::applyMethodName) return;
+                if (auto pe = mem->expr->to<IR::PathExpression>()) applies[pe->path->name]++;
+            });
+        for (auto decl : control->controlLocals) {
+            auto table = decl->to<IR::P4Table>();
+            TableKey key;
+            if (table == nullptr || !collectKey(table, metadata, metaParam, key)) continue;
+            key.applies = applies[table->name.name];
+            if (key.applies > 0) keys.push_back(key);
+        }
+    }
+    if (keys.empty()) return p;
+
+    // Lay out the keys of the most frequently applied tables first.
+    std::stable_sort(keys.begin(), keys.end(), [](const TableKey &a, const TableKey &b) {
+        if (a.applies != b.applies) return a.applies > b.applies;
+        return a.fields.size() > b.fields.size();
+    });
+    auto cost = [&](const IR::IndexedVector<IR::StructField> &fields) {
+        unsigned result = 0;
+        for (auto &key : keys)
+            if (!isContiguous(key, fields)) result += key.applies * key.fields.size();
+        return result;
+    };
+    auto fields = layout(metadata, keys);
+    if (cost(fields) >= cost(metadata->fields)) {
+        LOG1("Metadata layout left unchanged, no table key copy eliminated");
+        return p;
+    }
+
+    unsigned tables = 0;
+    unsigned copies = 0;
+    unsigned remaining = 0;
+    for (auto &key : keys) {
+        if (!isContiguous(key, fields)) {
+            if (key.copied) remaining++;
+        } else if (!isContiguous(key, metadata->fields)) {
+            LOG2("Key of table " << key.table->name << " is now contiguous in metadata");
+            tables++;
+            if (key.copied) copies += key.applies * key.fields.size();
+        }
+    }
+    LOG1("Metadata reordered for table keys: " << tables << " tables made contiguous, " << copies
+                                               << " key copy instructions eliminated, "
+                                               << remaining << " tables still copy their keys");
+    auto s = metadata->clone();
+    s->fields = fields;
+    p->objects[index] = s;
+    return p;
+}
+
 const IR::Node *StatementUnroll::preorder(IR::AssignmentStatement *a) {
     auto code_block = new IR::IndexedVector<IR::StatOrDecl>;
     auto right = a->right;
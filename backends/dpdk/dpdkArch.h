@@ -225,6 +225,49 @@ class InjectFixedMetadataField : public Transform {
     const IR::Node *preorder(IR::Type_Struct *s) override;
 };
 
+/// This pass reorders the fields of the single metadata struct so that the keys
+/// of exact match and learner tables matching only on metadata fields are
+/// contiguous, in key order. CopyMatchKeysToSingleStruct then neither copies
+/// these keys into new metadata fields before each apply, nor turns the table
+/// into a wildcard table.
+/// Tables are laid out by decreasing number of apply calls and key fields. A
+/// table whose key fields were already placed apart for another table keeps
+/// its copy. The fields are whole metadata fields, so the byte alignment set
+/// up by AlignHdrMetaField is not affected, and the fields that are not keys
+/// keep their relative order. The fields of the architecture metadata and the
+/// fields injected by InjectFixedMetadataField keep their place, and tables
+/// whose key uses one of them are left alone. The new layout is only used if
+/// fewer keys need copies than with the original one.
+/// This pass has to be applied after InjectJumboStruct and before the metadata
+/// struct is type checked again.
+class ReorderMetadataForTableKeys : public Transform {
+    DpdkProgramStructure *structure;
+    /// Metadata fields which are not moved.
+    std::set<cstring> fixedFields;
+
+    struct TableKey {
+        const IR::P4Table *table;
+        /// Metadata fields of the key, in key order.
+        std::vector<cstring> fields;
+        unsigned applies;
+        /// CopyMatchKeysToSingleStruct copies the key if it is not contiguous.
+        bool copied;
+    };
+
+    static bool isLearnerTable(const IR::P4Table *t);
+    bool collectKey(const IR::P4Table *table, const IR::Type_Struct *metadata, cstring metaParam,
+                    TableKey &key);
+    static bool isContiguous(const TableKey &key, const IR::IndexedVector<IR::StructField> &fields);
+    IR::IndexedVector<IR::StructField> layout(const IR::Type_Struct *metadata,
+                                              const std::vector<TableKey> &keys) const;
+
+ public:
+    explicit ReorderMetadataForTableKeys(DpdkProgramStructure *structure) : structure(structure) {
+        setName("ReorderMetadataForTableKeys");
+    }
+    const IR::Node *preorder(IR::P4Program *p) override;
+};
+
 /// This pass replaces unaligned header fields with aligned header fields
 /// by combining few contiguous header fields and replaces uses with slices
 /// to preserve the behavior
@@ -0,0 +1,618 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dpdkAsmCfgOpt.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <set>
+
+#include "dpdkUtils.h"
+#include "lib/log.h"
+
+namespace P4::DPDK {
+
+/// Appends the variable read or written by @p expr to @p into.
+/// @returns false if @p expr is not a field or a constant.
+static bool addOperand(const IR::Expression *expr, std::vector<cstring> &into) {
+    if (expr == nullptr || expr->is<IR::Constant>()) return true;
+    if (expr->is<IR::Member>() || expr->is<IR::PathExpression>()) {
+        into.push_back(expr->toString());
+        return true;
+    }
+    return false;
+}
+
+DpdkInstrEffect DpdkInstrEffect::of(const IR::DpdkAsmStatement *stmt) {
+    DpdkInstrEffect e;
+    if (auto mv = stmt->to<IR::DpdkMovhStatement>()) {
+        e.known = addOperand(mv->dst, e.uses) && addOperand(mv->src, e.uses) &&
+                  addOperand(mv->dst, e.clobbers);
+    } else if (auto mv = stmt->to<IR::DpdkMovStatement>()) {
+        e.known = addOperand(mv->dst, e.defs) && addOperand(mv->src, e.uses);
+    } else if (auto c = stmt->to<IR::DpdkCastStatement>()) {
+        e.known = addOperand(c->dst, e.defs) && addOperand(c->src, e.uses);
+    } else if (auto b = stmt->to<IR::DpdkBinaryStatement>()) {
+        e.known = addOperand(b->dst, e.defs) && addOperand(b->src1, e.uses) &&
+                  addOperand(b->src2, e.uses);
+    } else if (auto r = stmt->to<IR::DpdkRegisterReadStatement>()) {
+        e.known = addOperand(r->dst, e.defs) && addOperand(r->index, e.uses);
+    } else if (auto j = stmt->to<IR::DpdkJmpCondStatement>()) {
+        e.known = addOperand(j->src1, e.uses) && addOperand(j->src2, e.uses);
+    } else if (auto j = stmt->to<IR::DpdkJmpHeaderStatement>()) {
+        // The validity of the header.
+        e.known = addOperand(j->header, e.uses);
+    } else if (stmt->is<IR::DpdkJmpStatement>() || stmt->is<IR::DpdkLabelStatement>() ||
+               stmt->is<IR::DpdkReturnStatement>()) {
+        e.known = true;
+    }
+    return e;
+}
+
+DpdkAsmCfg::DpdkAsmCfg(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) : stmts(stmts) {
+    auto close = [this](size_t begin, size_t end) {
+        Block b;
+        b.begin = begin;
+        b.end = end;
+        blocks.push_back(b);
+    };
+    size_t begin = 0;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        auto stmt = stmts.at(i);
+        if (stmt->is<IR::DpdkLabelStatement>() && i > begin) {
+            close(begin, i);
+            begin = i;
+        }
+        if (stmt->is<IR::DpdkJmpStatement>() || stmt->is<IR::DpdkReturnStatement>()) {
+            close(begin, i + 1);
+            begin = i + 1;
+        }
+    }
+    if (begin < stmts.size()) close(begin, stmts.size());
+
+    std::map<cstring, size_t> labels;
+    for (size_t b = 0; b < blocks.size(); b++) {
+        if (auto label = stmts.at(blocks[b].begin)->to<IR::DpdkLabelStatement>())
+            labels.emplace(label->label, b);
+    }
+
+    for (size_t b = 0; b < blocks.size(); b++) {
+        auto &block = blocks[b];
+        auto last = stmts.at(block.end - 1);
+        bool fallthrough = true;
+        if (auto jmp = last->to<IR::DpdkJmpStatement>()) {
+            auto target = labels.find(jmp->label);
+            if (target != labels.end())
+                block.succs.push_back(target->second);
+            else
+                block.exits = true;
+            fallthrough = !jmp->is<IR::DpdkJmpLabelStatement>();
+        } else if (last->is<IR::DpdkReturnStatement>()) {
+            block.exits = true;
+            fallthrough = false;
+        }
+        if (fallthrough) {
+            if (b + 1 < blocks.size())
+                block.succs.push_back(b + 1);
+            else
+                block.exits = true;
+        }
+        for (auto s : block.succs) blocks[s].preds.push_back(b);
+    }
+}
+
+std::vector<bool> DpdkAsmCfg::reachable() const {
+    std::vector<bool> result(blocks.size(), false);
+    if (blocks.empty()) return result;
+    std::vector<size_t> work = {0};
+    result[0] = true;
+    while (!work.empty()) {
+        auto b = work.back();
+        work.pop_back();
+        for (auto s : blocks[b].succs) {
+            if (result[s]) continue;
+            result[s] = true;
+            work.push_back(s);
+        }
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> RemoveUnreachableInstructions::optimize(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    DpdkAsmCfg cfg(stmts);
+    auto reachable = cfg.reachable();
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t b = 0; b < cfg.blocks.size(); b++) {
+        for (size_t i = cfg.blocks[b].begin; i < cfg.blocks[b].end; i++) {
+            auto stmt = stmts.at(i);
+            if (reachable[b] || stmt->is<IR::DpdkLabelStatement>()) result.push_back(stmt);
+        }
+    }
+    return result;
+}
+
+const IR::DpdkJmpStatement *InvertJumpOverJump::invert(const IR::DpdkJmpStatement *jmp,
+                                                       cstring label) {
+    if (auto j = jmp->to<IR::DpdkJmpEqualStatement>())
+        return new IR::DpdkJmpNotEqualStatement(label, j->src1, j->src2);
+    if (auto j = jmp->to<IR::DpdkJmpNotEqualStatement>())
+        return new IR::DpdkJmpEqualStatement(label, j->src1, j->src2);
+    if (auto j = jmp->to<IR::DpdkJmpLessStatement>())
+        return new IR::DpdkJmpGreaterEqualStatement(label, j->src1, j->src2);
+    if (auto j = jmp->to<IR::DpdkJmpGreaterEqualStatement>())
+        return new IR::DpdkJmpLessStatement(label, j->src1, j->src2);
+    if (auto j = jmp->to<IR::DpdkJmpGreaterStatement>())
+        return new IR::DpdkJmpLessOrEqualStatement(label, j->src1, j->src2);
+    if (auto j = jmp->to<IR::DpdkJmpLessOrEqualStatement>())
+        return new IR::DpdkJmpGreaterStatement(label, j->src1, j->src2);
+    if (jmp->is<IR::DpdkJmpHitStatement>()) return new IR::DpdkJmpMissStatement(label);
+    if (jmp->is<IR::DpdkJmpMissStatement>()) return new IR::DpdkJmpHitStatement(label);
+    if (auto j = jmp->to<IR::DpdkJmpIfValidStatement>())
+        return new IR::DpdkJmpIfInvalidStatement(label, j->header);
+    if (auto j = jmp->to<IR::DpdkJmpIfInvalidStatement>())
+        return new IR::DpdkJmpIfValidStatement(label, j->header);
+    if (auto j = jmp->to<IR::DpdkJmpIfActionRunStatement>()) {
+        auto result = new IR::DpdkJmpIfActionNotRunStatement(label, j->action.name);
+        result->action = j->action;
+        return result;
+    }
+    if (auto j = jmp->to<IR::DpdkJmpIfActionNotRunStatement>()) {
+        auto result = new IR::DpdkJmpIfActionRunStatement(label, j->action.name);
+        result->action = j->action;
+        return result;
+    }
+    return nullptr;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> InvertJumpOverJump::optimize(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        auto stmt = stmts.at(i);
+        auto cond = stmt->to<IR::DpdkJmpStatement>();
+        if (cond != nullptr && !cond->is<IR::DpdkJmpLabelStatement>() && i + 2 < stmts.size()) {
+            auto jmp = stmts.at(i + 1)->to<IR::DpdkJmpLabelStatement>();
+            auto label = stmts.at(i + 2)->to<IR::DpdkLabelStatement>();
+            if (jmp != nullptr && label != nullptr && label->label == cond->label) {
+                if (auto inverted = invert(cond, jmp->label)) {
+                    result.push_back(inverted);
+                    // Skip the unconditional jump.
+                    i++;
+                    continue;
+                }
+            }
+        }
+        result.push_back(stmt);
+    }
+    return result;
+}
+
+namespace {
+
+/// A set of variables, which may contain all the variables but a few.
+class LiveSet {
+    /// If set, the set contains all the variables except those in vars.
+    bool complement = false;
+    std::set<cstring> vars;
+
+ public:
+    bool contains(cstring v) const { return complement != (vars.count(v) != 0); }
+    void add(cstring v) {
+        if (complement)
+            vars.erase(v);
+        else
+            vars.insert(v);
+    }
+    void remove(cstring v) {
+        if (complement)
+            vars.insert(v);
+        else
+            vars.erase(v);
+    }
+    void setAll() {
+        complement = true;
+        vars.clear();
+    }
+    void unionWith(const LiveSet &other) {
+        std::set<cstring> result;
+        if (!complement && !other.complement) {
+            vars.insert(other.vars.begin(), other.vars.end());
+            return;
+        }
+        if (complement && other.complement) {
+            std::set_intersection(vars.begin(), vars.end(), other.vars.begin(), other.vars.end(),
+                                  std::inserter(result, result.begin()));
+        } else {
+            const auto &excluded = complement ? vars : other.vars;
+            const auto &included = complement ? other.vars : vars;
+            std::set_difference(excluded.begin(), excluded.end(), included.begin(),
+                                included.end(), std::inserter(result, result.begin()));
+        }
+        complement = true;
+        vars = std::move(result);
+    }
+    bool operator==(const LiveSet &other) const {
+        return complement == other.complement && vars == other.vars;
+    }
+    bool operator!=(const LiveSet &other) const { return !(*this == other); }
+};
+
+void updateLiveness(const DpdkInstrEffect &effect, LiveSet &live) {
+    if (!effect.known) {
+        live.setAll();
+        return;
+    }
+    for (auto d : effect.defs) live.remove(d);
+    for (auto u : effect.uses) live.add(u);
+}
+
+}  // namespace
+
+IR::IndexedVector<IR::DpdkAsmStatement> EliminateDeadStores::optimize(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    auto current = stmts;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        DpdkAsmCfg cfg(current);
+        std::vector<DpdkInstrEffect> effects;
+        for (auto stmt : current) effects.push_back(DpdkInstrEffect::of(stmt));
+
+        auto liveOut = [&](size_t b, const std::vector<LiveSet> &liveIn) {
+            LiveSet out;
+            if (cfg.blocks[b].exits) out.setAll();
+            for (auto s : cfg.blocks[b].succs) out.unionWith(liveIn[s]);
+            return out;
+        };
+
+        std::vector<LiveSet> liveIn(cfg.blocks.size());
+        bool iterate = true;
+        while (iterate) {
+            iterate = false;
+            for (size_t b = cfg.blocks.size(); b-- > 0;) {
+                LiveSet live = liveOut(b, liveIn);
+                for (size_t i = cfg.blocks[b].end; i-- > cfg.blocks[b].begin;)
+                    updateLiveness(effects[i], live);
+                if (live != liveIn[b]) {
+                    liveIn[b] = live;
+                    iterate = true;
+                }
+            }
+        }
+
+        std::vector<bool> dead(current.size(), false);
+        for (size_t b = 0; b < cfg.blocks.size(); b++) {
+            LiveSet live = liveOut(b, liveIn);
+            for (size_t i = cfg.blocks[b].end; i-- > cfg.blocks[b].begin;) {
+                auto stmt = current.at(i);
+                auto &effect = effects[i];
+                bool removable = (stmt->is<IR::DpdkMovStatement>() ||
+                                  stmt->is<IR::DpdkCastStatement>() ||
+                                  stmt->is<IR::DpdkBinaryStatement>()) &&
+                                 effect.known && effect.defs.size() == 1 &&
+                                 effect.defs[0].startsWith("m.");
+                if (removable && !live.contains(effect.defs[0])) {
+                    LOG3("Removing dead store " << stmt);
+                    dead[i] = true;
+                    changed = true;
+                    continue;
+                }
+                updateLiveness(effect, live);
+            }
+        }
+
+        if (changed) {
+            IR::IndexedVector<IR::DpdkAsmStatement> result;
+            for (size_t i = 0; i < current.size(); i++)
+                if (!dead[i]) result.push_back(current.at(i));
+            current = result;
+        }
+    }
+    return current;
+}
+
+/// Collects the width of the bit<N> fields of the metadata structure,
+/// indexed like DpdkInstrEffect.
+static void collectMetadataWidths(const IR::DpdkAsmProgram *p,
+                                  std::unordered_map<cstring, int> &widths) {
+    for (auto st : p->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields) {
+            if (auto tb = field->type->to<IR::Type_Bits>())
+                widths.emplace(cstring("m." + field->name.name), tb->width_bits());
+        }
+    }
+}
+
+const IR::Node *PropagateCopies::preorder(IR::DpdkAsmProgram *p) {
+    widths.clear();
+    collectMetadataWidths(p, widths);
+    return p;
+}
+
+bool PropagateCopies::isValuePreservingCopy(cstring dst, const IR::Expression *src) const {
+    auto dw = widths.find(dst);
+    if (dw == widths.end() || dw->second > 64) return false;
+    if (auto c = src->to<IR::Constant>())
+        return c->value >= 0 && c->value < (big_int(1) << dw->second);
+    if (!src->is<IR::Member>()) return false;
+    auto sw = widths.find(src->toString());
+    return sw != widths.end() && sw->second <= dw->second;
+}
+
+namespace {
+
+/// Available copies: destination -> source.
+using Copies = std::map<cstring, const IR::Expression *>;
+
+bool sameCopies(const Copies &a, const Copies &b) {
+    if (a.size() != b.size()) return false;
+    for (auto &[dst, src] : a) {
+        auto it = b.find(dst);
+        if (it == b.end() || it->second->toString() != src->toString()) return false;
+    }
+    return true;
+}
+
+void killCopies(Copies &copies, cstring var) {
+    copies.erase(var);
+    for (auto it = copies.begin(); it != copies.end();) {
+        if (it->second->toString() == var)
+            it = copies.erase(it);
+        else
+            ++it;
+    }
+}
+
+/// Follows the chain of available copies from @p expr.
+const IR::Expression *resolveCopy(const Copies &copies, const IR::Expression *expr,
+                                  bool allowConst) {
+    if (expr == nullptr || !expr->is<IR::Member>()) return expr;
+    // Chains are acyclic, this only bounds the work.
+    for (int i = 0; i < 8; i++) {
+        auto it = copies.find(expr->toString());
+        if (it == copies.end()) break;
+        if (it->second->is<IR::Constant>()) return allowConst ? it->second : expr;
+        expr = it->second;
+    }
+    return expr;
+}
+
+}  // namespace
+
+IR::IndexedVector<IR::DpdkAsmStatement> PropagateCopies::optimize(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    auto transfer = [this](const IR::DpdkAsmStatement *stmt, Copies &copies) {
+        auto effect = DpdkInstrEffect::of(stmt);
+        if (!effect.known) {
+            copies.clear();
+            return;
+        }
+        for (auto d : effect.defs) killCopies(copies, d);
+        for (auto d : effect.clobbers) killCopies(copies, d);
+        if (auto mv = stmt->to<IR::DpdkMovStatement>()) {
+            auto dst = mv->dst->toString();
+            if (dst != mv->src->toString() && isValuePreservingCopy(dst, mv->src))
+                copies[dst] = mv->src;
+        }
+    };
+
+    DpdkAsmCfg cfg(stmts);
+    size_t n = cfg.blocks.size();
+    // Copies available at the end of each block; nullopt until it is computed.
+    std::vector<std::optional<Copies>> out(n);
+    auto copiesIn = [&](size_t b) {
+        Copies in;
+        if (b == 0) return in;
+        bool first = true;
+        for (auto p : cfg.blocks[b].preds) {
+            if (!out[p]) continue;
+            if (first) {
+                in = *out[p];
+                first = false;
+                continue;
+            }
+            for (auto it = in.begin(); it != in.end();) {
+                auto other = out[p]->find(it->first);
+                if (other == out[p]->end() ||
+                    other->second->toString() != it->second->toString())
+                    it = in.erase(it);
+                else
+                    ++it;
+            }
+        }
+        return in;
+    };
+
+    bool iterate = true;
+    while (iterate) {
+        iterate = false;
+        for (size_t b = 0; b < n; b++) {
+            Copies copies = copiesIn(b);
+            for (size_t i = cfg.blocks[b].begin; i < cfg.blocks[b].end; i++)
+                transfer(stmts.at(i), copies);
+            if (!out[b] || !sameCopies(*out[b], copies)) {
+                out[b] = std::move(copies);
+                iterate = true;
+            }
+        }
+    }
+
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t b = 0; b < n; b++) {
+        Copies copies = copiesIn(b);
+        for (size_t i = cfg.blocks[b].begin; i < cfg.blocks[b].end; i++) {
+            const IR::DpdkAsmStatement *stmt = stmts.at(i);
+            if (auto mv = stmt->to<IR::DpdkMovStatement>()) {
+                auto src = resolveCopy(copies, mv->src, true);
+                if (src->toString() == mv->dst->toString()) {
+                    // The destination already holds the value.
+                    LOG3("Removing redundant copy " << stmt);
+                    continue;
+                }
+                if (src != mv->src) {
+                    auto newMv = mv->clone();
+                    newMv->src = src;
+                    stmt = newMv;
+                }
+            } else if (auto bin = stmt->to<IR::DpdkBinaryStatement>()) {
+                auto src2 = resolveCopy(copies, bin->src2, true);
+                if (src2 != bin->src2) {
+                    auto newBin = bin->clone();
+                    newBin->src2 = src2;
+                    stmt = newBin;
+                }
+            } else if (auto jmp = stmt->to<IR::DpdkJmpCondStatement>()) {
+                // DPDK does not allow a constant as the first operand.
+                auto src1 = resolveCopy(copies, jmp->src1, false);
+                auto src2 = resolveCopy(copies, jmp->src2, true);
+                if (src1 != jmp->src1 || src2 != jmp->src2) {
+                    auto newJmp = jmp->clone();
+                    newJmp->src1 = src1;
+                    newJmp->src2 = src2;
+                    stmt = newJmp;
+                }
+            }
+            transfer(stmt, copies);
+            result.push_back(stmt);
+        }
+    }
+    return result;
+}
+
+void CoalesceMetadataTemporaries::escape(const IR::Node *node) {
+    forAllMatching<IR::Member>(node, [this](const IR::Member *m) {
+        if (m->expr->toString() == "m") escaping.insert(m->toString());
+    });
+}
+
+void CoalesceMetadataTemporaries::scanList(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    DpdkAsmCfg cfg(stmts);
+    for (auto &block : cfg.blocks) {
+        size_t id = nextBlock++;
+        auto note = [&](cstring var, size_t pos, bool isDef) {
+            if (!var.startsWith("m.")) return;
+            auto it = ranges.find(var);
+            if (it == ranges.end()) {
+                ranges.emplace(var, Range{id, pos, pos, isDef});
+            } else if (it->second.block != id) {
+                escaping.insert(var);
+            } else {
+                it->second.last = pos;
+            }
+        };
+        for (size_t i = block.begin; i < block.end; i++) {
+            auto stmt = stmts.at(i);
+            auto effect = DpdkInstrEffect::of(stmt);
+            if (!effect.known) {
+                escape(stmt);
+                continue;
+            }
+            // A field read and written by the same instruction is read first.
+            for (auto u : effect.uses) note(u, i, false);
+            for (auto d : effect.defs) note(d, i, true);
+        }
+    }
+}
+
+const IR::Node *CoalesceMetadataTemporaries::preorder(IR::DpdkAsmProgram *p) {
+    collectMetadataWidths(p, widths);
+    for (auto a : p->actions) scanList(a->statements);
+    for (auto s : p->statements) {
+        if (auto l = s->to<IR::DpdkListStatement>())
+            scanList(l->statements);
+        else
+            escape(s);
+    }
+    for (auto t : p->tables) escape(t);
+    for (auto l : p->learners) escape(l);
+    for (auto s : p->selectors) escape(s);
+    for (auto e : p->externDeclarations) escape(e);
+    for (auto g : p->globals) escape(g);
+
+    struct Storage {
+        cstring field;
+        std::vector<Range> live;
+    };
+    std::map<int, std::vector<Storage>> storage;
+    for (const auto &[var, range] : ranges) {
+        if (escaping.count(var) || !range.firstIsDef) continue;
+        auto width = widths.find(var);
+        if (width == widths.end()) continue;
+        // Architecture metadata may be read by other pipelines.
+        if (var.startsWith("m.psa_") || var.startsWith("m.pna_")) continue;
+        auto &candidates = storage[width->second];
+        bool shared = false;
+        for (auto &s : candidates) {
+            if (std::none_of(s.live.begin(), s.live.end(),
+                             [&range](const Range &r) { return r.overlaps(range); })) {
+                renames.emplace(var, s.field);
+                s.live.push_back(range);
+                shared = true;
+                break;
+            }
+        }
+        if (!shared) candidates.push_back({var, {range}});
+    }
+    for (auto &[from, to] : renames) LOG2("Coalescing " << from << " into " << to);
+    return p;
+}
+
+const IR::Node *CoalesceMetadataTemporaries::postorder(IR::Member *m) {
+    if (m->expr->toString() != "m") return m;
+    auto it = renames.find(m->toString());
+    if (it == renames.end()) return m;
+    // it->second is "m.<field>".
+    m->member = IR::ID(it->second.substr(2));
+    return m;
+}
+
+/// Counts the instructions of the actions and apply blocks of @p node.
+static size_t countInstructions(const IR::Node *node) {
+    auto p = node->to<IR::DpdkAsmProgram>();
+    if (p == nullptr) return 0;
+    size_t count = 0;
+    auto countList = [&count](const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+        for (auto s : stmts)
+            if (!s->is<IR::DpdkLabelStatement>()) count++;
+    };
+    for (auto a : p->actions) countList(a->statements);
+    for (auto s : p->statements) {
+        if (auto l = s->to<IR::DpdkListStatement>())
+            countList(l->statements);
+        else
+            count++;
+    }
+    return count;
+}
+
+DpdkAsmCfgOptimization::DpdkAsmCfgOptimization() {
+    setName("DpdkAsmCfgOptimization");
+    addPasses({
+        new VisitFunctor([this](const IR::Node *root) {
+            before = countInstructions(root);
+            return root;
+        }),
+        new PassRepeated({
+            new RemoveUnreachableInstructions,
+            new InvertJumpOverJump,
+            new PropagateCopies,
+            new EliminateDeadStores,
+            new DpdkAsmOptimization,
+        }),
+        new CoalesceMetadataTemporaries,
+        new VisitFunctor([this](const IR::Node *root) {
+            after = countInstructions(root);
+            LOG1("DPDK CFG optimization: " << before << " instructions before, " << after
+                                           << " after");
+            return root;
+        }),
+    });
+}
+
+}  // namespace P4::DPDK
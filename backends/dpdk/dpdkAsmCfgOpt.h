@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_DPDK_DPDKASMCFGOPT_H_
+#define BACKENDS_DPDK_DPDKASMCFGOPT_H_
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "dpdkAsmOpt.h"
+#include "ir/ir.h"
+
+namespace P4::DPDK {
+
+/// Variables read and written by a DPDK assembly instruction. As in
+/// CollectUseDefInfo, variables are identified by the string of their
+/// expression, e.g. "m.local_metadata_tmp".
+struct DpdkInstrEffect {
+    /// False if the instruction may access variables that are not listed here
+    /// (table lookups, extracts, externs, ...). Such instructions are treated
+    /// as reading every variable and overwriting every copy.
+    bool known = false;
+    /// Variables overwritten by the instruction.
+    std::vector<cstring> defs;
+    /// Variables partially overwritten by the instruction (movh); they are
+    /// also listed in uses.
+    std::vector<cstring> clobbers;
+    /// Variables read by the instruction.
+    std::vector<cstring> uses;
+
+    static DpdkInstrEffect of(const IR::DpdkAsmStatement *stmt);
+};
+
+/// Basic blocks and control flow graph of the instructions of an action or
+/// of an apply block. A block starts at a label or after a jump, and ends with
+/// a jump, a return or before the next label. Jumps to labels that are not in
+/// the instruction list (e.g. LABEL_DROP) and falling off the end of the list
+/// leave the graph.
+class DpdkAsmCfg {
+ public:
+    struct Block {
+        /// Instructions [begin, end) of the list.
+        size_t begin = 0;
+        size_t end = 0;
+        std::vector<size_t> succs;
+        std::vector<size_t> preds;
+        /// Control may leave the instruction list from this block.
+        bool exits = false;
+    };
+
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts;
+    std::vector<Block> blocks;
+
+    explicit DpdkAsmCfg(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts);
+    /// @returns for every block whether it is reachable from the first one.
+    std::vector<bool> reachable() const;
+};
+
+/// Base class for the passes that rewrite the instructions of actions and of
+/// apply blocks, one list at a time.
+class DpdkAsmListOptimizer : public Transform {
+ protected:
+    virtual IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) = 0;
+
+ public:
+    const IR::Node *postorder(IR::DpdkListStatement *l) override {
+        l->statements = optimize(l->statements);
+        return l;
+    }
+
+    const IR::Node *postorder(IR::DpdkAction *a) override {
+        a->statements = optimize(a->statements);
+        return a;
+    }
+};
+
+/// This pass removes the instructions of blocks that cannot be reached from
+/// the start of the list. Labels are kept; RemoveRedundantLabel removes them
+/// when no jump refers to them anymore.
+class RemoveUnreachableInstructions : public DpdkAsmListOptimizer {
+ protected:
+    IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) override;
+};
+
+/// This pass replaces a conditional jump over an unconditional one by the
+/// opposite conditional jump. For example,
+/// jmpeq LABEL_1 m.a m.b
+/// jmp LABEL_2
+/// LABEL_1 :
+///
+/// becomes:
+/// jmpneq LABEL_2 m.a m.b
+/// LABEL_1 :
+class InvertJumpOverJump : public DpdkAsmListOptimizer {
+    static const IR::DpdkJmpStatement *invert(const IR::DpdkJmpStatement *jmp, cstring label);
+
+ protected:
+    IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) override;
+};
+
+/// This pass removes stores to metadata fields that are overwritten on every
+/// path before being read, using a liveness analysis over DpdkAsmCfg. All
+/// variables are live when control leaves the list.
+class EliminateDeadStores : public DpdkAsmListOptimizer {
+ protected:
+    IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) override;
+};
+
+/// This pass propagates copies between metadata fields, and of constants into
+/// metadata fields, across basic blocks: a read of the destination of a copy
+/// is replaced by its source when the copy is available on every path. Only
+/// copies that preserve the value, i.e. from a source no wider than the
+/// destination, are propagated. Copies that become dead are then removed by
+/// EliminateDeadStores.
+class PropagateCopies : public DpdkAsmListOptimizer {
+    /// Width of the metadata fields, indexed like DpdkInstrEffect.
+    std::unordered_map<cstring, int> widths;
+
+    bool isValuePreservingCopy(cstring dst, const IR::Expression *src) const;
+
+ protected:
+    IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) override;
+
+ public:
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+};
+
+/// This pass lets metadata fields used as temporaries share storage. A field
+/// is a temporary if it is only accessed by instructions of a single basic
+/// block, and first written there; its value is dead outside that block.
+/// Temporaries of the same width whose live ranges do not overlap are renamed
+/// to a single field, and RemoveUnusedMetadataFields then drops the others.
+/// Temporaries are considered by name, and each is renamed to the first kept
+/// field it does not interfere with, so the result does not depend on the
+/// order in which the instructions are visited.
+class CoalesceMetadataTemporaries : public Transform {
+    struct Range {
+        /// Unique id of the basic block.
+        size_t block;
+        size_t first;
+        size_t last;
+        bool firstIsDef;
+
+        bool overlaps(const Range &other) const {
+            return block == other.block && first <= other.last && other.first <= last;
+        }
+    };
+    std::unordered_map<cstring, int> widths;
+    /// Sorted by name.
+    std::map<cstring, Range> ranges;
+    std::unordered_set<cstring> escaping;
+    std::map<cstring, cstring> renames;
+    size_t nextBlock = 0;
+
+    void escape(const IR::Node *node);
+    void scanList(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts);
+
+ public:
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+    const IR::Node *postorder(IR::Member *m) override;
+};
+
+/// Optimizations of the instructions of actions and apply blocks based on
+/// their control flow graph. They run after DpdkAsmOptimization and
+/// CopyPropagationAndElimination, and log the number of instructions they
+/// saved.
+class DpdkAsmCfgOptimization : public PassManager {
+    size_t before = 0;
+    size_t after = 0;
+
+ public:
+    DpdkAsmCfgOptimization();
+};
+
+}  // namespace P4::DPDK
+
+#endif /* BACKENDS_DPDK_DPDKASMCFGOPT_H_ */
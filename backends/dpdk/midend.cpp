@@ -40,6 +40,7 @@
 #include "midend/flattenUnions.h"
 #include "midend/hsIndexSimplify.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeTables.h"
 #include "midend/midEndLast.h"
 #include "midend/nestedStructs.h"
 #include "midend/noMatch.h"
@@ -205,6 +206,7 @@ DpdkMidEnd::DpdkMidEnd(CompilerOptions &options, std::ostream *outStream) {
             }),
             new P4::MoveDeclarations(),
             validateTableProperties(options.arch),
+            options.mergeTables ? new P4::MergeTables(&typeMap) : nullptr,
             new P4::SimplifyControlFlow(&typeMap, true),
             new P4::SimplifySwitch(&typeMap),
             new P4::CompileTimeOperations(),
@@ -0,0 +1,308 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "codeSizeReport.h"
+
+#include "frontends/p4/coreLibrary.h"
+#include "frontends/p4/methodInstance.h"
+#include "lib/algorithm.h"
+#include "lib/nullstream.h"
+
+namespace P4::EBPF {
+
+/// Statements emitted around each table lookup: key construction, lookup,
+/// hit check and the action switch.
+static constexpr unsigned tableOverheadStatements = 6;
+
+unsigned CodeSizeEstimator::typeBits(const IR::Type *type) const {
+    auto t = typeMap->getTypeType(type, true);
+    if (auto tb = t->to<IR::Type_Bits>()) return tb->width_bits();
+    if (t->is<IR::Type_Boolean>()) return 8;
+    // Enums and errors are emitted as 32-bit integers.
+    if (t->is<IR::Type_Enum>() || t->is<IR::Type_Error>()) return 32;
+    if (auto se = t->to<IR::Type_SerEnum>()) return typeBits(se->type);
+    if (auto st = t->to<IR::Type_StructLike>()) {
+        // Each field is emitted as a byte-aligned member; headers also carry a validity byte.
+        unsigned bits = st->is<IR::Type_Header>() ? 8 : 0;
+        for (auto f : st->fields) bits += ROUNDUP(typeBits(f->type), 8) * 8;
+        return bits;
+    }
+    if (auto ta = t->to<IR::Type_Array>()) return typeBits(ta->elementType) * ta->getSize();
+    return 0;
+}
+
+unsigned CodeSizeEstimator::typeBytes(const IR::Type *type) const {
+    return ROUNDUP(typeBits(type), 8);
+}
+
+void CodeSizeEstimator::addLocals(const IR::IndexedVector<IR::Declaration> &locals) {
+    for (auto decl : locals) {
+        if (auto var = decl->to<IR::Declaration_Variable>())
+            currentStackBytes += typeBytes(typeMap->getTypeType(var->type, true));
+    }
+}
+
+CodeCost CodeSizeEstimator::callCost(const IR::MethodCallExpression *mce) {
+    auto mi = P4::MethodInstance::resolve(mce, refMap, typeMap);
+    if (auto apply = mi->to<P4::ApplyMethod>()) {
+        if (apply->isTableApply()) return tableCost(apply->object->to<IR::P4Table>());
+        return {};
+    }
+    if (auto ac = mi->to<P4::ActionCall>()) return actionCost(ac->action);
+    if (auto em = mi->to<P4::ExternMethod>()) {
+        auto &p4lib = P4::P4CoreLibrary::instance();
+        if (em->originalExternType->name == p4lib.packetIn.name) {
+            if (em->method->name == p4lib.packetIn.extract.name && mce->arguments->size() == 1) {
+                // A bounds check, one load per field and the validity bit.
+                auto type = typeMap->getType(mce->arguments->at(0)->expression, true);
+                unsigned fields = 0;
+                if (auto st = type->to<IR::Type_StructLike>()) fields = st->fields.size();
+                return CodeCost(fields + 2, 0);
+            }
+            return CodeCost(1, 0);
+        }
+        if (em->originalExternType->name == p4lib.packetOut.name) return CodeCost(1, 0);
+        // Other externs (counters, meters, registers, ...) are backed by BPF maps.
+        return CodeCost(1, 1);
+    }
+    if (mi->is<P4::ExternFunction>()) return CodeCost(1, 0);
+    return {};
+}
+
+CodeCost CodeSizeEstimator::expressionCost(const IR::Expression *expression) {
+    CodeCost cost;
+    forAllMatching<IR::MethodCallExpression>(
+        expression, [&](const IR::MethodCallExpression *mce) { cost += callCost(mce); });
+    return cost;
+}
+
+CodeCost CodeSizeEstimator::statementCost(const IR::StatOrDecl *stat) {
+    if (auto block = stat->to<IR::BlockStatement>()) {
+        CodeCost cost;
+        for (auto s : block->components) cost += statementCost(s);
+        return cost;
+    }
+    if (auto ifs = stat->to<IR::IfStatement>()) {
+        CodeCost cost = expressionCost(ifs->condition);
+        cost.statements++;
+        CodeCost ifTrue = statementCost(ifs->ifTrue);
+        CodeCost ifFalse = ifs->ifFalse ? statementCost(ifs->ifFalse) : CodeCost();
+        cost += CodeCost::max(ifTrue, ifFalse);
+        return cost;
+    }
+    if (auto sw = stat->to<IR::SwitchStatement>()) {
+        CodeCost cost = expressionCost(sw->expression);
+        cost.statements++;
+        CodeCost worst;
+        for (auto sc : sw->cases) {
+            if (sc->statement != nullptr)
+                worst = CodeCost::max(worst, statementCost(sc->statement));
+        }
+        cost += worst;
+        return cost;
+    }
+    if (auto mcs = stat->to<IR::MethodCallStatement>()) {
+        CodeCost cost = expressionCost(mcs->methodCall);
+        if (cost.statements == 0) cost.statements = 1;
+        return cost;
+    }
+    if (auto assign = stat->to<IR::BaseAssignmentStatement>()) {
+        CodeCost cost = expressionCost(assign->right);
+        cost.statements++;
+        return cost;
+    }
+    if (auto var = stat->to<IR::Declaration_Variable>()) {
+        currentStackBytes += typeBytes(typeMap->getTypeType(var->type, true));
+        CodeCost cost(1, 0);
+        if (var->initializer != nullptr) cost += expressionCost(var->initializer);
+        return cost;
+    }
+    if (stat->is<IR::EmptyStatement>()) return {};
+    return CodeCost(1, 0);
+}
+
+CodeCost CodeSizeEstimator::actionCost(const IR::P4Action *action) {
+    auto it = actionCosts.find(action);
+    if (it != actionCosts.end()) return it->second;
+    CodeCost cost = statementCost(action->body);
+    actionCosts.emplace(action, cost);
+    items.push_back({"action"_cs, action->externalName(), cost});
+    return cost;
+}
+
+CodeCost CodeSizeEstimator::tableCost(const IR::P4Table *table) {
+    auto it = tableCosts.find(table);
+    if (it != tableCosts.end()) return it->second;
+
+    auto &p4lib = P4::P4CoreLibrary::instance();
+    // One lookup in the table map and one in the default action map on a miss.
+    CodeCost cost(tableOverheadStatements, 2);
+    bool isTernary = false;
+    if (auto key = table->getKey()) {
+        for (auto ke : key->keyElements) {
+            cost.statements++;
+            currentStackBytes += typeBytes(typeMap->getType(ke->expression, true));
+            if (ke->matchType->path->name.name == p4lib.ternaryMatch.name) isTernary = true;
+        }
+    }
+    if (isTernary) {
+        // Tuple space search: the head of the mask list, then for every mask
+        // a lookup of the next mask, of the tuple map and of the tuple itself.
+        cost.lookups += 1 + 3 * maxTernaryMasks;
+        cost.statements += 20;
+    }
+
+    CodeCost worstAction;
+    if (auto al = table->getActionList()) {
+        for (auto ale : al->actionList) {
+            auto decl = refMap->getDeclaration(ale->getPath(), true);
+            if (auto action = decl->to<IR::P4Action>())
+                worstAction = CodeCost::max(worstAction, actionCost(action));
+        }
+    }
+    cost += worstAction;
+    tableCosts.emplace(table, cost);
+    items.push_back({"table"_cs, table->externalName(), cost});
+    return cost;
+}
+
+CodeCost CodeSizeEstimator::stateCost(const IR::ParserState *state) {
+    // The state label and trace message.
+    CodeCost cost(1, 0);
+    for (auto c : state->components) cost += statementCost(c);
+    if (auto select = state->selectExpression->to<IR::SelectExpression>()) {
+        cost += expressionCost(select->select);
+        // The select value declaration, one comparison per case and the final goto.
+        cost.statements += select->selectCases.size() + 2;
+        for (auto sc : select->selectCases) {
+            // Cases matching a value_set look the key up in a map.
+            if (sc->keyset->is<IR::PathExpression>()) cost.lookups++;
+        }
+    } else {
+        cost.statements++;
+    }
+    items.push_back({"parser state"_cs, state->externalName(), cost});
+    return cost;
+}
+
+CodeCost CodeSizeEstimator::worstParserPath(const IR::P4Parser *parser,
+                                            const IR::ParserState *state,
+                                            std::map<const IR::ParserState *, CodeCost> &memo,
+                                            std::set<const IR::ParserState *> &onPath) {
+    if (state == nullptr || state->isBuiltin()) return {};
+    auto it = memo.find(state);
+    if (it != memo.end()) return it->second;
+    // The generated code has no loops, so a back edge does not add to the path.
+    if (onPath.count(state)) return {};
+    onPath.insert(state);
+
+    std::vector<const IR::PathExpression *> next;
+    if (auto pe = state->selectExpression->to<IR::PathExpression>()) {
+        next.push_back(pe);
+    } else if (auto select = state->selectExpression->to<IR::SelectExpression>()) {
+        for (auto sc : select->selectCases) next.push_back(sc->state);
+    }
+    CodeCost worstNext;
+    for (auto pe : next) {
+        auto nextState = parser->states.getDeclaration<IR::ParserState>(pe->path->name.name);
+        worstNext = CodeCost::max(worstNext, worstParserPath(parser, nextState, memo, onPath));
+    }
+
+    onPath.erase(state);
+    CodeCost cost = stateCost(state);
+    cost += worstNext;
+    memo.emplace(state, cost);
+    return cost;
+}
+
+bool CodeSizeEstimator::preorder(const IR::P4Parser *parser) {
+    currentStackBytes = 0;
+    addLocals(parser->parserLocals);
+    std::map<const IR::ParserState *, CodeCost> memo;
+    std::set<const IR::ParserState *> onPath;
+    auto start = parser->states.getDeclaration<IR::ParserState>(IR::ParserState::start);
+    CodeCost worst = worstParserPath(parser, start, memo, onPath);
+    // States unreachable from start still emit code.
+    for (auto state : parser->states) {
+        if (!state->isBuiltin() && !memo.count(state)) stateCost(state);
+    }
+    paths.push_back({parser, "parser"_cs, parser->externalName(), worst, currentStackBytes});
+    return false;
+}
+
+bool CodeSizeEstimator::preorder(const IR::P4Control *control) {
+    currentStackBytes = 0;
+    addLocals(control->controlLocals);
+    CodeCost worst = statementCost(control->body);
+    paths.push_back({control, "control"_cs, control->externalName(), worst, currentStackBytes});
+    return false;
+}
+
+unsigned CodeSizeEstimator::maxStackBytes() const {
+    unsigned result = 0;
+    for (auto &p : paths) result = std::max(result, p.stackBytes);
+    return result;
+}
+
+void CodeSizeEstimator::report(std::ostream &out) const {
+    out << "Estimated size of generated code" << std::endl;
+    for (auto &item : items) {
+        out << item.kind << " " << item.name << ": " << item.cost.statements << " statements, "
+            << item.cost.lookups << " map lookups" << std::endl;
+    }
+    out << std::endl << "Worst paths" << std::endl;
+    for (auto &p : paths) {
+        out << p.kind << " " << p.name << ": " << p.worst.statements << " statements, "
+            << p.worst.lookups << " map lookups, " << p.stackBytes << " bytes of stack"
+            << std::endl;
+    }
+    out << std::endl << "Largest stack: " << maxStackBytes() << " bytes" << std::endl;
+}
+
+bool CodeSizeEstimator::checkBudget(const EbpfOptions &options) const {
+    bool fits = true;
+    for (auto &p : paths) {
+        if (options.maxPathStatements != 0 && p.worst.statements > options.maxPathStatements) {
+            ::P4::error(ErrorType::ERR_OVERLIMIT,
+                        "%1%: estimated %2% statements on the worst path exceed the budget of %3%",
+                        p.node, p.worst.statements, options.maxPathStatements);
+            fits = false;
+        }
+        if (options.maxPathLookups != 0 && p.worst.lookups > options.maxPathLookups) {
+            ::P4::error(ErrorType::ERR_OVERLIMIT,
+                        "%1%: estimated %2% map lookups on the worst path exceed the budget of %3%",
+                        p.node, p.worst.lookups, options.maxPathLookups);
+            fits = false;
+        }
+        if (options.maxStackBytes != 0 && p.stackBytes > options.maxStackBytes) {
+            ::P4::error(ErrorType::ERR_OVERLIMIT,
+                        "%1%: estimated stack usage of %2% bytes exceeds the budget of %3% bytes",
+                        p.node, p.stackBytes, options.maxStackBytes);
+            fits = false;
+        }
+    }
+    return fits;
+}
+
+bool estimateCodeSize(const EbpfOptions &options, const IR::P4Program *program,
+                      P4::ReferenceMap *refMap, P4::TypeMap *typeMap) {
+    bool hasBudget =
+        options.maxPathStatements != 0 || options.maxPathLookups != 0 || options.maxStackBytes != 0;
+    if (options.sizeReportFile.empty() && !hasBudget) return true;
+
+    CodeSizeEstimator estimator(refMap, typeMap, options.maxTernaryMasks);
+    program->apply(estimator);
+
+    if (!options.sizeReportFile.empty()) {
+        if (auto out = openFile(options.sizeReportFile, false)) {
+            estimator.report(*out);
+            out->flush();
+        }
+    }
+    return estimator.checkBudget(options);
+}
+
+}  // namespace P4::EBPF
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_EBPF_CODESIZEREPORT_H_
+#define BACKENDS_EBPF_CODESIZEREPORT_H_
+
+#include "ebpfOptions.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/ir.h"
+
+namespace P4::EBPF {
+
+/// Estimated cost of a piece of generated C code.
+struct CodeCost {
+    /// Number of emitted C statements.
+    unsigned statements = 0;
+    /// Number of BPF map lookups.
+    unsigned lookups = 0;
+
+    CodeCost() = default;
+    CodeCost(unsigned statements, unsigned lookups) : statements(statements), lookups(lookups) {}
+
+    CodeCost &operator+=(const CodeCost &other) {
+        statements += other.statements;
+        lookups += other.lookups;
+        return *this;
+    }
+    /// Component-wise maximum, used to pick the worst of several alternative paths.
+    static CodeCost max(const CodeCost &a, const CodeCost &b) {
+        return CodeCost(std::max(a.statements, b.statements), std::max(a.lookups, b.lookups));
+    }
+};
+
+/// Estimates from the midend IR how much C code the eBPF and TC back-ends emit
+/// for each parser state, table and action: the number of statements, the
+/// number of map lookups on the worst path, and the stack taken by the local
+/// variables and table keys of each parser and control. The numbers
+/// approximate what the code generators do and are meant to catch programs
+/// likely to hit verifier limits before they are loaded.
+class CodeSizeEstimator : public Inspector {
+    P4::ReferenceMap *refMap;
+    P4::TypeMap *typeMap;
+    unsigned maxTernaryMasks;
+
+    /// One line of the report.
+    struct Item {
+        cstring kind;
+        cstring name;
+        CodeCost cost;
+    };
+    /// Worst path through a parser or a control.
+    struct Path {
+        const IR::Node *node;
+        cstring kind;
+        cstring name;
+        CodeCost worst;
+        unsigned stackBytes;
+    };
+
+    std::vector<Item> items;
+    std::vector<Path> paths;
+    std::map<const IR::P4Action *, CodeCost> actionCosts;
+    std::map<const IR::P4Table *, CodeCost> tableCosts;
+    /// Stack usage of the parser or control being visited.
+    unsigned currentStackBytes = 0;
+
+    unsigned typeBits(const IR::Type *type) const;
+    unsigned typeBytes(const IR::Type *type) const;
+    void addLocals(const IR::IndexedVector<IR::Declaration> &locals);
+
+    CodeCost callCost(const IR::MethodCallExpression *mce);
+    CodeCost expressionCost(const IR::Expression *expression);
+    CodeCost statementCost(const IR::StatOrDecl *stat);
+    CodeCost actionCost(const IR::P4Action *action);
+    CodeCost tableCost(const IR::P4Table *table);
+    CodeCost stateCost(const IR::ParserState *state);
+    CodeCost worstParserPath(const IR::P4Parser *parser, const IR::ParserState *state,
+                             std::map<const IR::ParserState *, CodeCost> &memo,
+                             std::set<const IR::ParserState *> &onPath);
+
+ public:
+    CodeSizeEstimator(P4::ReferenceMap *refMap, P4::TypeMap *typeMap, unsigned maxTernaryMasks)
+        : refMap(refMap), typeMap(typeMap), maxTernaryMasks(maxTernaryMasks) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+        setName("CodeSizeEstimator");
+    }
+
+    bool preorder(const IR::P4Parser *parser) override;
+    bool preorder(const IR::P4Control *control) override;
+
+    /// Estimated stack usage of the parser or control taking the most, in bytes.
+    unsigned maxStackBytes() const;
+    void report(std::ostream &out) const;
+    /// Reports an error for every estimate exceeding the budget in @p options.
+    /// @returns false if the budget was exceeded.
+    bool checkBudget(const EbpfOptions &options) const;
+};
+
+/// Runs CodeSizeEstimator over @p program if a report or a budget was requested
+/// in @p options. @returns false if the program exceeds the budget.
+bool estimateCodeSize(const EbpfOptions &options, const IR::P4Program *program,
+                      P4::ReferenceMap *refMap, P4::TypeMap *typeMap);
+
+}  // namespace P4::EBPF
+
+#endif /* BACKENDS_EBPF_CODESIZEREPORT_H_ */
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "ebpfBackend.h"
 
+#include "codeSizeReport.h"
 #include "ebpfProgram.h"
 #include "ebpfType.h"
 #include "frontends/p4/evaluator/evaluator.h"
@@ -86,6 +87,8 @@ void run_ebpf_backend(const EbpfOptions &options, const IR::ToplevelBlock *tople
         return;
     }
 
+    if (!estimateCodeSize(options, toplevel->getProgram(), refMap, typeMap)) return;
+
     if (options.arch.isNullOrEmpty() || options.arch == "filter") {
         emitFilterModel(options, target, toplevel, refMap, typeMap);
     } else if (options.arch == "psa") {
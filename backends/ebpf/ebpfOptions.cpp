@@ -93,6 +93,43 @@ EbpfOptions::EbpfOptions() {
             return true;
         },
         "[psa only] Enable caching entries for tables with lpm or ternary key");
+    registerOption(
+        "--percpu-counters", nullptr,
+        [this](const char *) {
+            perCPUCounters = true;
+            return true;
+        },
+        "[psa only] Use per-CPU maps for indexed Counter externs; "
+        "the control plane has to sum up values of all CPUs when reading them");
+    registerOption(
+        "--emit-size-report", "file",
+        [this](const char *arg) {
+            sizeReportFile = arg;
+            return true;
+        },
+        "Write the estimated size of the generated code per parser state, table and action "
+        "to file");
+    registerOption(
+        "--max-path-statements", "N",
+        [this](const char *arg) {
+            maxPathStatements = std::strtoul(arg, nullptr, 0);
+            return true;
+        },
+        "Fail if the estimated number of statements on the worst path exceeds N");
+    registerOption(
+        "--max-path-lookups", "N",
+        [this](const char *arg) {
+            maxPathLookups = std::strtoul(arg, nullptr, 0);
+            return true;
+        },
+        "Fail if the estimated number of map lookups on the worst path exceeds N");
+    registerOption(
+        "--max-stack-bytes", "N",
+        [this](const char *arg) {
+            maxStackBytes = std::strtoul(arg, nullptr, 0);
+            return true;
+        },
+        "Fail if the estimated stack usage of a parser or control exceeds N bytes");
     registerOption(
         "--xdp", nullptr,
         [this](const char *) {
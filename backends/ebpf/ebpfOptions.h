@@ -41,6 +41,16 @@ class EbpfOptions : public CompilerOptions {
     unsigned int maxTernaryMasks = 128;
     /// Enable table cache for LPM and ternary tables
     bool enableTableCache = false;
+    /// Use per-CPU maps for indexed counters
+    bool perCPUCounters = false;
+    /// File to write the estimated code size report to
+    std::filesystem::path sizeReportFile;
+    /// Budget for the estimated statements on the worst path (0 = unlimited)
+    unsigned maxPathStatements = 0;
+    /// Budget for the estimated map lookups on the worst path (0 = unlimited)
+    unsigned maxPathLookups = 0;
+    /// Budget for the estimated stack usage in bytes (0 = unlimited)
+    unsigned maxStackBytes = 0;
 
     EbpfOptions();
 
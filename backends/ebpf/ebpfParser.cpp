@@ -23,6 +23,37 @@ limitations under the License.
 
 namespace P4::EBPF {
 
+/// Width in bits of the load_X helper used to read a field of @p widthToExtract bits
+/// starting @p alignment bits into its first byte.
+static unsigned scalarLoadWidth(unsigned widthToExtract, unsigned alignment) {
+    unsigned wordsToRead = (widthToExtract + alignment - 1) / 8 + 1;
+    if (wordsToRead <= 1) return 8;
+    if (wordsToRead <= 2) return 16;
+    if (wordsToRead <= 4) return 32;
+    // TODO: this is wrong, since a 60-bit unaligned read may require 9 words.
+    if (wordsToRead > 64) BUG("Unexpected width %d", widthToExtract);
+    return 64;
+}
+
+/// True if a field of @p widthToExtract bits starting @p alignment bits into its first byte
+/// is copied from the packet byte by byte, instead of being read with a larger load_X.
+static bool isCopiedField(unsigned widthToExtract, unsigned alignment) {
+    return alignment == 0 && widthToExtract % 8 == 0 && widthToExtract > 8;
+}
+
+/// Number of bytes from the header start touched when extracting a field
+/// of @p widthToExtract bits placed at @p hdrOffsetBits.
+static unsigned lastByteRead(unsigned hdrOffsetBits, unsigned widthToExtract) {
+    unsigned alignment = hdrOffsetBits % 8;
+    unsigned firstByte = hdrOffsetBits / 8;
+    if (isCopiedField(widthToExtract, alignment)) return firstByte + widthToExtract / 8;
+    if (widthToExtract <= 64) return firstByte + scalarLoadWidth(widthToExtract, alignment) / 8;
+    unsigned bytes = ROUNDUP(widthToExtract, 8);
+    if (alignment == 0) return firstByte + bytes;
+    // Unaligned wide fields are read byte by byte using load_half().
+    return firstByte + bytes + 1;
+}
+
 void StateTranslationVisitor::compileLookahead(const IR::Expression *destination) {
     cstring msgStr = absl::StrFormat("Parser: lookahead for %v %v",
                                      state->parser->typeMap->getType(destination), destination);
@@ -284,27 +315,42 @@ void StateTranslationVisitor::compileExtractField(const IR::Expression *expr,
     msgStr = absl::StrFormat("Parser: extracting field %v", fieldName);
     builder->target->emitTraceMessage(builder, msgStr.c_str());
 
-    if (widthToExtract <= 64) {
-        unsigned lastBitIndex = widthToExtract + alignment - 1;
-        unsigned lastWordIndex = lastBitIndex / 8;
-        unsigned wordsToRead = lastWordIndex + 1;
-        unsigned loadSize;
-
+    if (widthToExtract <= 64 && isCopiedField(widthToExtract, alignment) &&
+        widthToExtract != scalarLoadWidth(widthToExtract, alignment)) {
+        // Byte-aligned fields with a width that is not a load size, e.g. 48-bit MAC
+        // addresses, are copied into the high-order bytes of the field, which holds a
+        // big-endian word of the load size, and converted to host byte order in place.
+        // Unlike a larger load_X, this does not read past the end of the field.
+        unsigned loadSize = scalarLoadWidth(widthToExtract, alignment);
+        builder->emitIndent();
+        visit(expr);
+        builder->appendFormat(".%s = 0", fieldName.c_str());
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->append("__builtin_memcpy(&");
+        visit(expr);
+        builder->appendFormat(".%s, %s + BYTES(%u), %u)", fieldName.c_str(),
+                              program->headerStartVar.c_str(), hdrOffsetBits, widthToExtract / 8);
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        visit(expr);
+        builder->appendFormat(".%s = (", fieldName.c_str());
+        type->emit(builder);
+        builder->appendFormat(")(%s(", loadSize == 32 ? "bpf_ntohl" : "bpf_be64_to_cpu");
+        visit(expr);
+        builder->appendFormat(".%s) >> %u)", fieldName.c_str(), loadSize - widthToExtract);
+        builder->endOfStatement(true);
+    } else if (widthToExtract <= 64) {
+        unsigned loadSize = scalarLoadWidth(widthToExtract, alignment);
         const char *helper = nullptr;
-        if (wordsToRead <= 1) {
+        if (loadSize == 8) {
             helper = "load_byte";
-            loadSize = 8;
-        } else if (wordsToRead <= 2) {
+        } else if (loadSize == 16) {
             helper = "load_half";
-            loadSize = 16;
-        } else if (wordsToRead <= 4) {
+        } else if (loadSize == 32) {
             helper = "load_word";
-            loadSize = 32;
         } else {
-            // TODO: this is wrong, since a 60-bit unaligned read may require 9 words.
-            if (wordsToRead > 64) BUG("Unexpected width %d", widthToExtract);
             helper = "load_dword";
-            loadSize = 64;
         }
 
         unsigned shift = loadSize - alignment - widthToExtract;
@@ -344,36 +390,47 @@ void StateTranslationVisitor::compileExtractField(const IR::Expression *expr,
                 field);
         }
 
-        // wide values; read all bytes one by one.
-        unsigned shift;
-        if (alignment == 0)
-            shift = 0;
-        else
-            shift = 8 - alignment;
-
-        const char *helper;
-        if (shift == 0)
-            helper = "load_byte";
-        else
-            helper = "load_half";
-        auto bt = EBPFTypeFactory::instance->create(IR::Type_Bits::get(8));
         unsigned bytes = ROUNDUP(widthToExtract, 8);
-        for (unsigned i = 0; i < bytes; i++) {
+        if (isCopiedField(widthToExtract, alignment)) {
+            // Byte-aligned wide values are kept in network byte order,
+            // so the whole field is copied from the packet at once.
             builder->emitIndent();
+            builder->append("__builtin_memcpy(&");
             visit(expr);
-            builder->appendFormat(".%s[%d] = (", fieldName.c_str(), i);
-            bt->emit(builder);
-            builder->appendFormat(")((%s(%s, BYTES(%u) + %d) >> %d)", helper,
-                                  program->headerStartVar.c_str(), hdrOffsetBits, i, shift);
+            builder->appendFormat(".%s[0], %s + BYTES(%u), %u)", fieldName.c_str(),
+                                  program->headerStartVar.c_str(), hdrOffsetBits, bytes);
+            builder->endOfStatement(true);
+        } else {
+            // unaligned wide values; read all bytes one by one.
+            unsigned shift;
+            if (alignment == 0)
+                shift = 0;
+            else
+                shift = 8 - alignment;
 
-            if ((i == bytes - 1) && (widthToExtract % 8 != 0)) {
-                builder->append(" & EBPF_MASK(");
+            const char *helper;
+            if (shift == 0)
+                helper = "load_byte";
+            else
+                helper = "load_half";
+            auto bt = EBPFTypeFactory::instance->create(IR::Type_Bits::get(8));
+            for (unsigned i = 0; i < bytes; i++) {
+                builder->emitIndent();
+                visit(expr);
+                builder->appendFormat(".%s[%d] = (", fieldName.c_str(), i);
                 bt->emit(builder);
-                builder->appendFormat(", %d)", widthToExtract % 8);
-            }
+                builder->appendFormat(")((%s(%s, BYTES(%u) + %d) >> %d)", helper,
+                                      program->headerStartVar.c_str(), hdrOffsetBits, i, shift);
 
-            builder->append(")");
-            builder->endOfStatement(true);
+                if ((i == bytes - 1) && (widthToExtract % 8 != 0)) {
+                    builder->append(" & EBPF_MASK(");
+                    bt->emit(builder);
+                    builder->appendFormat(", %d)", widthToExtract % 8);
+                }
+
+                builder->append(")");
+                builder->endOfStatement(true);
+            }
         }
     }
 
@@ -426,25 +483,20 @@ void StateTranslationVisitor::compileExtract(const IR::Expression *destination)
     builder->target->emitTraceMessage(builder, "Parser: check pkt_len=%d >= last_read_byte=%d", 2,
                                       program->lengthVar.c_str(), offsetStr.c_str());
 
-    // to load some fields the compiler will use larger words
-    // than actual width of a field (e.g. 48-bit field loaded using load_dword())
-    // we must ensure that the larger word is not outside of packet buffer.
-    // FIXME: this can fail if a packet does not contain additional payload after header.
-    //  However, we don't have better solution in case of using load_X functions to parse packet.
-    // TODO: consider using a collection of smaller widths.
+    // Byte-aligned fields are copied without reading past their end, but unaligned fields
+    // may be loaded with larger words than they span, e.g. a 20-bit field at bit 4 of a
+    // byte spans 3 bytes and is read with load_word().  We must ensure that the larger word
+    // is not outside of packet buffer, so the single bounds check below covers the furthest
+    // byte touched by any load.
     unsigned curr_padding = 0;
+    unsigned fieldOffsetBits = 0;
     for (auto f : ht->fields) {
         auto ftype = state->parser->typeMap->getType(f);
         auto etype = EBPFTypeFactory::instance->create(ftype);
-        if (etype->is<EBPFScalarType>()) {
-            auto scalarType = etype->to<EBPFScalarType>();
-            unsigned readWordSize = scalarType->alignment() * 8;
-            unsigned unaligned = scalarType->widthInBits() % readWordSize;
-            unsigned padding = readWordSize - unaligned;
-            if (padding == readWordSize) padding = 0;
-            if (scalarType->widthInBits() + padding >= curr_padding) {
-                curr_padding = padding;
-            }
+        if (auto et = etype->to<IHasWidth>()) {
+            unsigned readEnd = lastByteRead(fieldOffsetBits, et->widthInBits()) * 8;
+            if (readEnd > width) curr_padding = std::max(curr_padding, readEnd - width);
+            fieldOffsetBits += et->widthInBits();
         }
     }
 
@@ -283,6 +283,13 @@ void EBPFTable::emitValueType(CodeBuilder *builder) {
         builder->newline();
         builder->emitIndent();
         builder->appendLine("__u8 has_next;");
+        if (hasConstEntries()) {
+            // Upper bound on the priority of entries in this tuple and all tuples following it.
+            // Only emitted for tables with const entries, so the layout written by a control
+            // plane into tables it may modify is unchanged.
+            builder->emitIndent();
+            builder->appendLine("__u32 max_priority;");
+        }
         builder->blockEnd(false);
         builder->endOfStatement(true);
     }
@@ -765,6 +772,19 @@ void EBPFTable::emitLookup(CodeBuilder *builder, cstring key, cstring value) {
     builder->emitIndent();
     builder->appendLine("break;");
     builder->blockEnd(true);
+    if (hasConstEntries()) {
+        builder->emitIndent();
+        builder->appendFormat(
+            "if (%v != NULL && v->max_priority != 0 && v->max_priority <= %v->priority) ", value,
+            value);
+        builder->blockStart();
+        builder->target->emitTraceMessage(
+            builder, "Control: [Ternary] No remaining tuple can beat priority=%d, stopping lookup.",
+            1, absl::StrFormat("%v->priority", value).c_str());
+        builder->emitIndent();
+        builder->appendLine("break;");
+        builder->blockEnd(true);
+    }
     builder->emitIndent();
     cstring new_key = "k"_cs;
     builder->appendFormat("struct %v %v = {};", keyTypeName, new_key);
@@ -898,6 +918,12 @@ bool EBPFTable::isTernaryTable() const {
     return false;
 }
 
+bool EBPFTable::hasConstEntries() const {
+    if (table == nullptr) return false;
+    auto ep = table->container->properties->getProperty(IR::TableProperties::entriesPropertyName);
+    return ep != nullptr && ep->isConstant;
+}
+
 ////////////////////////////////////////////////////////////////
 
 EBPFCounterTable::EBPFCounterTable(const EBPFProgram *program, const IR::ExternBlock *block,
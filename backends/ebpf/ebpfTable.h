@@ -77,6 +77,9 @@ class EBPFTable : public EBPFTableBase {
  public:
     bool isLPMTable() const;
     bool isTernaryTable() const;
+    /// True if the table is declared with `const entries`, so that no control plane
+    /// can add entries to it and the priorities of all its entries are known at compile time.
+    bool hasConstEntries() const;
 
  protected:
     void emitTernaryInstance(CodeBuilder *builder);
@@ -37,6 +37,7 @@ limitations under the License.
 #include "midend/eliminateTuples.h"
 #include "midend/expandEmit.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeTables.h"
 #include "midend/midEndLast.h"
 #include "midend/noMatch.h"
 #include "midend/parserUnroll.h"
@@ -105,6 +106,7 @@ const IR::ToplevelBlock *MidEnd::run(EbpfOptions &options, const IR::P4Program *
              new P4::RemoveSelectBooleans(&typeMap),
              new P4::SingleArgumentSelect(&typeMap),
              new P4::ConstantFolding(&typeMap),
+             options.mergeTables ? new P4::MergeTables(&typeMap) : nullptr,
              new P4::SimplifyControlFlow(&typeMap, true),
              new P4::TableHit(&typeMap),
              new P4::RemoveLeftSlices(&typeMap),
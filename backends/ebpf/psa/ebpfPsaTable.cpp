@@ -477,7 +477,8 @@ void EBPFTablePSA::emitValueStructStructure(CodeBuilder *builder) {
 void EBPFTablePSA::emitInstance(CodeBuilder *builder) {
     if (isTernaryTable()) {
         emitTernaryInstance(builder);
-        if (hasConstEntries()) {
+        // Tuples are preallocated for the entries installed by emitConstEntriesInitializer.
+        if (table->container->getEntries() != nullptr) {
             auto entries = getConstEntriesGroupedByMask();
             // A number of tuples is equal to number of unique masks
             unsigned nrOfTuples = entries.size();
@@ -679,7 +680,7 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
     cstring valueMask = program->refMap->newName("value_mask");
     cstring nextMask = keyMasksNames[0];
     int noTupleId = -1;
-    emitValueMask(builder, valueMask, nextMask, noTupleId);
+    emitValueMask(builder, valueMask, nextMask, noTupleId, 0);
     builder->newline();
 
     builder->emitIndent();
@@ -703,7 +704,10 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
         } else {
             nextMask = nullptr;
         }
-        emitValueMask(builder, valueMask, nextMask, tuple_id);
+        // Groups are sorted by priority, so the first entry of this group bounds
+        // the priority of every entry in this and all following tuples. The bound is
+        // only emitted for const entries, which a control plane cannot outrank.
+        emitValueMask(builder, valueMask, nextMask, tuple_id, sameMaskEntries.front().priority);
         builder->newline();
         emitKeysAndValues(builder, sameMaskEntries, keyNames, valueNames);
 
@@ -802,7 +806,7 @@ void EBPFTablePSA::emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &en
 }
 
 void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
-                                 const cstring nextMask, int tupleId) const {
+                                 const cstring nextMask, int tupleId, unsigned maxPriority) const {
     builder->emitIndent();
     builder->appendFormat("struct %v_mask %v = {0}", valueTypeName, valueMask);
     builder->endOfStatement(true);
@@ -810,6 +814,11 @@ void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
     builder->emitIndent();
     builder->appendFormat("%v.tuple_id = %d", valueMask, tupleId);
     builder->endOfStatement(true);
+    if (hasConstEntries()) {
+        builder->emitIndent();
+        builder->appendFormat("%v.max_priority = %u", valueMask, maxPriority);
+        builder->endOfStatement(true);
+    }
     builder->emitIndent();
     if (nextMask.isNullOrEmpty()) {
         builder->appendFormat("%v.has_next = 0", valueMask);
@@ -835,7 +844,8 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
 
     // Group entries by the same mask, container will do deduplication for us. The order of
     // entries will be changed but this is not a problem because of priority. Ebpf algorithm use
-    // TSS, so every mask have to be tested and there is no strict requirements on masks order.
+    // TSS, so every mask could be tested, but tuples are ordered by their highest priority
+    // to let the lookup stop as soon as no remaining tuple can beat the current match.
     // Priority of entries is equal to P4 program order (first defined has the highest priority).
     EBPFTablePSATernaryTableMaskGenerator maskGenerator(program->refMap, program->typeMap);
     std::unordered_map<cstring, std::vector<ConstTernaryEntryDesc>> entriesGroupedByMask;
@@ -848,18 +858,17 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
         entriesGroupedByMask[mask].emplace_back(desc);
     }
 
-    // build results
+    // build results; entries within a group keep program order, so the front
+    // entry of each group has the highest priority in that group.
     for (auto &vec : entriesGroupedByMask) {
         result.emplace_back(std::move(vec.second));
     }
+    std::sort(result.begin(), result.end(), [](const EntriesGroup_t &a, const EntriesGroup_t &b) {
+        return a.front().priority > b.front().priority;
+    });
     return result;
 }
 
-bool EBPFTablePSA::hasConstEntries() {
-    const IR::EntriesList *entries = table->container->getEntries();
-    return entries && entries->size() > 0;
-}
-
 cstring EBPFTablePSA::addPrefixFunc(bool trace) {
     cstring addPrefixFunc =
         "static __always_inline\n"
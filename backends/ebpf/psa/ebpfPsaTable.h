@@ -25,7 +25,6 @@ class EBPFTablePSA : public EBPFTable {
     typedef std::vector<ConstTernaryEntryDesc> EntriesGroup_t;
     typedef std::vector<EntriesGroup_t> EntriesGroupedByMask_t;
     EntriesGroupedByMask_t getConstEntriesGroupedByMask();
-    bool hasConstEntries();
     const cstring addPrefixFunctionName = "add_prefix_and_entries"_cs;
     const cstring tuplesMapName = instanceName + "_tuples_map"_cs;
     const cstring prefixesMapName = instanceName + "_prefixes"_cs;
@@ -50,8 +49,8 @@ class EBPFTablePSA : public EBPFTable {
     void emitConstEntriesInitializer(CodeBuilder *builder);
     void emitTernaryConstEntriesInitializer(CodeBuilder *builder);
     void emitMapUpdateTraceMsg(CodeBuilder *builder, cstring mapName, cstring returnCode) const;
-    void emitValueMask(CodeBuilder *builder, cstring valueMask, cstring nextMask,
-                       int tupleId) const;
+    void emitValueMask(CodeBuilder *builder, cstring valueMask, cstring nextMask, int tupleId,
+                       unsigned maxPriority) const;
     void emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &entriesGroupedByMask,
                       std::vector<cstring> &keyMasksNames);
     void emitKeysAndValues(CodeBuilder *builder, EntriesGroup_t &sameMaskEntries,
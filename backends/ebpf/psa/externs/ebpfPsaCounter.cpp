@@ -71,6 +71,10 @@ EBPFCounterPSA::EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration
     // TODO: add more advance logic to decide whether used map will be HASH_MAP or ARRAY_MAP
     isHash = false;
 
+    // Direct counters live inside table entries, so only indexed counters
+    // can get an array map of their own for each CPU.
+    isPerCPU = !isDirect && !isHash && program->options.perCPUCounters;
+
     // check index type
     indexWidthType = nullptr;
     if (!isDirect) {
@@ -155,7 +159,7 @@ void EBPFCounterPSA::emitValueType(CodeBuilder *builder) {
 }
 
 void EBPFCounterPSA::emitInstance(CodeBuilder *builder) {
-    TableKind kind = isHash ? TableHash : TableArray;
+    TableKind kind = isPerCPU ? TablePerCPUArray : (isHash ? TableHash : TableArray);
     builder->target->emitTableDecl(builder, dataMapName, kind, keyTypeName,
                                    "struct " + valueTypeName, size);
 }
@@ -246,10 +250,14 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
         builder->blockStart();
     }
 
+    // Each CPU has its own copy of a per-CPU map value, so no atomic operation is needed.
     if (type == CounterType::BYTES || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%vbytes), %v)", targetWAccess,
-                              program->lengthVar);
+        if (isPerCPU)
+            builder->appendFormat("%vbytes += %v", targetWAccess, program->lengthVar);
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%vbytes), %v)", targetWAccess,
+                                  program->lengthVar);
         builder->endOfStatement(true);
 
         varStr = absl::StrFormat("%sbytes", targetWAccess.c_str());
@@ -257,7 +265,10 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
     }
     if (type == CounterType::PACKETS || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
+        if (isPerCPU)
+            builder->appendFormat("%vpackets += 1", targetWAccess);
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
         builder->endOfStatement(true);
 
         varStr = absl::StrFormat("%spackets", targetWAccess.c_str());
@@ -18,6 +18,8 @@ class EBPFCounterPSA : public EBPFCounterTable {
     EBPFType *dataplaneWidthType;
     EBPFType *indexWidthType;
     bool isDirect;
+    /// Counter values are kept in a per-CPU map and updated without atomic operations.
+    bool isPerCPU = false;
 
  public:
     enum CounterType { PACKETS, BYTES, PACKETS_AND_BYTES };
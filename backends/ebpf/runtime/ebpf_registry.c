@@ -16,6 +16,8 @@ typedef struct {
     char name[MAX_TABLE_NAME_LENGTH];   // name of the map
     struct bpf_table *tbl;            // ptr to the map
     int handle;                         // id of the map
+    uint64_t lookups;                   // number of lookups in the map
+    uint64_t hits;                      // number of successful lookups
     UT_hash_handle h_name;              // the hash handle for names
     UT_hash_handle h_id;                // the hash handle for ids
 } registry_entry;
@@ -49,7 +51,7 @@ int registry_add(struct bpf_table *tbl) {
         return EXIT_FAILURE;
     }
     // Add the table
-    tmp_reg = malloc(sizeof(registry_entry));
+    tmp_reg = calloc(1, sizeof(registry_entry));
     if (!tmp_reg) {
         perror("Fatal: Could not allocate memory\n");
         exit(EXIT_FAILURE);
@@ -138,20 +140,26 @@ int registry_delete_table_elem_id(int tbl_id, void *key) {
     return bpf_map_delete_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);;
 }
 
-void *registry_lookup_table_elem(const char *name, void *key) {
-    struct bpf_table *tmp_tbl = registry_lookup_table(name);
-    if (tmp_tbl == NULL)
+static void *lookup_and_count(registry_entry *tmp_reg, void *key) {
+    if (tmp_reg == NULL)
         // not found, return
         return NULL;
-    return bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    struct bpf_table *tmp_tbl = tmp_reg->tbl;
+    void *value = bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    tmp_reg->lookups++;
+    if (value != NULL)
+        tmp_reg->hits++;
+    return value;
+}
+
+void *registry_lookup_table_elem(const char *name, void *key) {
+    return lookup_and_count(find_register(name), key);
 }
 
 void *registry_lookup_table_elem_id(int tbl_id, void *key) {
-    struct bpf_table *tmp_tbl = registry_lookup_table_id(tbl_id);
-    if (tmp_tbl == NULL)
-        // not found, return
-        return NULL;
-    return bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    registry_entry *tmp_reg;
+    HASH_FIND(h_id, reg_tables_id, &tbl_id, sizeof(int), tmp_reg);
+    return lookup_and_count(tmp_reg, key);
 }
 
 int registry_get_id(const char *name) {
@@ -160,3 +168,24 @@ int registry_get_id(const char *name) {
         return -1;
     return tmp_reg->handle;
 }
+
+void registry_reset_lookup_stats() {
+    registry_entry *curr_tbl, *tmp_tbl;
+    HASH_ITER(h_name, reg_tables_name, curr_tbl, tmp_tbl) {
+        curr_tbl->lookups = 0;
+        curr_tbl->hits = 0;
+    }
+}
+
+void registry_print_lookup_stats(FILE *out, uint64_t num_pkts) {
+    registry_entry *curr_tbl, *tmp_tbl;
+    HASH_ITER(h_name, reg_tables_name, curr_tbl, tmp_tbl) {
+        if (curr_tbl->lookups == 0)
+            continue;
+        fprintf(out, "  %.*s: %llu lookups, %llu hits", MAX_TABLE_NAME_LENGTH, curr_tbl->name,
+                (unsigned long long) curr_tbl->lookups, (unsigned long long) curr_tbl->hits);
+        if (num_pkts != 0)
+            fprintf(out, ", %.2f lookups/packet", (double) curr_tbl->lookups / num_pkts);
+        fprintf(out, "\n");
+    }
+}
@@ -12,6 +12,8 @@
 #ifndef BACKENDS_EBPF_RUNTIME_EBPF_REGISTRY_H_
 #define BACKENDS_EBPF_RUNTIME_EBPF_REGISTRY_H_
 
+#include <stdio.h>      // FILE
+#include <stdint.h>     // uint64_t
 #include "ebpf_map.h"
 
 #define MAX_TABLE_NAME_LENGTH 256  // maximum length of the table name
@@ -121,4 +123,15 @@ void *registry_lookup_table_elem(const char *name, void *key);
 /// @return NULL if the value cannot be found.
 void *registry_lookup_table_elem_id(int tbl_id, void *key);
 
+/// @brief Reset the lookup counters of all tables.
+/// @details Every lookup issued through the registry is counted per table,
+/// together with the number of lookups which returned a value.
+void registry_reset_lookup_stats();
+
+/// @brief Print the lookup counters of all tables.
+/// @details Prints the number of lookups and hits of every table
+/// that has been looked up since the last reset. If num_pkts is
+/// not zero, the average number of lookups per packet is printed as well.
+void registry_print_lookup_stats(FILE *out, uint64_t num_pkts);
+
 #endif  // BACKENDS_EBPF_RUNTIME_EBPF_REGISTRY_H_
@@ -9,6 +9,7 @@
 #include <ctype.h>      // isprint()
 #include <string.h>     // memcpy()
 #include <stdlib.h>     // malloc()
+#include <time.h>       // clock_gettime()
 #include "ebpf_test.h"
 #include "ebpf_runtime_test.h"
 
@@ -69,6 +70,58 @@ void *run_and_record_output(packet_filter ebpf_filter, const char *pcap_base, pc
     delete_array(output_array);
 }
 
+static uint64_t get_time_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int run_benchmark(packet_filter ebpf_filter, pcap_list_t *pkt_list, uint64_t iterations, int debug) {
+    // Preload all packets into one contiguous buffer to keep allocation and
+    // list traversal out of the measured loop.
+    pcap_buffer_t *buf = flatten_pkt_list(pkt_list);
+    if (buf->num_pkts == 0) {
+        fprintf(stderr, "No input packets, nothing to benchmark.\n");
+        delete_pkt_buffer(buf);
+        return EXIT_FAILURE;
+    }
+    // The program may rewrite the packet, so each run works on a scratch copy.
+    char *scratch = malloc(buf->max_len ? buf->max_len : 1);
+    if (scratch == NULL) {
+        perror("Fatal: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t passed = 0;
+    registry_reset_lookup_stats();
+    uint64_t start = get_time_ns();
+    for (uint64_t it = 0; it < iterations; it++) {
+        for (uint32_t i = 0; i < buf->num_pkts; i++) {
+            struct sk_buff skb;
+            memcpy(scratch, buf->data + buf->offsets[i], buf->lengths[i]);
+            skb.data = (void *) scratch;
+            skb.len = buf->lengths[i];
+            skb.ifindex = buf->ifindex[i];
+            if (ebpf_filter(&skb) != 0)
+                passed++;
+        }
+    }
+    uint64_t elapsed = get_time_ns() - start;
+    uint64_t total = iterations * buf->num_pkts;
+    printf("Benchmark: %u packets x %llu iterations\n", buf->num_pkts,
+           (unsigned long long) iterations);
+    printf("  total: %llu packets (%llu passed) in %.3f ms\n", (unsigned long long) total,
+           (unsigned long long) passed, elapsed / 1e6);
+    if (elapsed != 0)
+        printf("  throughput: %.0f packets/sec\n", total * 1e9 / elapsed);
+    printf("  latency: %.1f ns/packet\n", (double) elapsed / total);
+    registry_print_lookup_stats(stdout, total);
+    if (debug)
+        printf("Largest packet in the benchmark: %u bytes\n", buf->max_len);
+    free(scratch);
+    delete_pkt_buffer(buf);
+    return EXIT_SUCCESS;
+}
+
 void init_ebpf_tables(int debug) {
     // Initialize the registry of shared tables.
     struct bpf_table* current = tables;
@@ -17,11 +17,17 @@
 typedef int (*packet_filter)(SK_BUFF* s);
 
 void *run_and_record_output(packet_filter ebpf_filter, const char *pcap_base, pcap_list_t *pkt_list, int debug);
+/// Runs all packets of the list through the filter for the given number of
+/// iterations and prints throughput, latency and per-table lookup counters.
+/// Returns EXIT_FAILURE if there are no packets.
+int run_benchmark(packet_filter ebpf_filter, pcap_list_t *pkt_list, uint64_t iterations, int debug);
 void init_ebpf_tables(int debug);
 void delete_ebpf_tables(int debug);
 
 #define RUN(ebpf_filter, pcap_base, num_pcaps, input_list, debug) \
     run_and_record_output(ebpf_filter, pcap_base, input_list, debug)
+#define BENCHMARK(ebpf_filter, input_list, iterations, debug) \
+    run_benchmark(ebpf_filter, input_list, iterations, debug)
 #define INIT_EBPF_TABLES(debug) init_ebpf_tables(debug)
 #define DELETE_EBPF_TABLES(debug) delete_ebpf_tables(debug)
 
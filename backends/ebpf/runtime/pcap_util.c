@@ -220,6 +220,49 @@ pcap_pkt *copy_pkt(pcap_pkt *src_pkt) {
     return new_pkt;
 }
 
+pcap_buffer_t *flatten_pkt_list(pcap_list_t *pkt_list) {
+    pcap_buffer_t *buf = calloc(1, sizeof(pcap_buffer_t));
+    if (buf == NULL) {
+        perror("Fatal: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    /* Compute the total size first, so the data is allocated only once */
+    size_t total_len = 0;
+    for (uint32_t i = 0; i < pkt_list->len; i++) {
+        uint32_t pkt_len = pkt_list->pkts[i]->pcap_hdr.len;
+        total_len += pkt_len;
+        if (pkt_len > buf->max_len)
+            buf->max_len = pkt_len;
+    }
+    buf->num_pkts = pkt_list->len;
+    buf->data = malloc(total_len ? total_len : 1);
+    buf->offsets = calloc(buf->num_pkts + 1, sizeof(uint32_t));
+    buf->lengths = calloc(buf->num_pkts + 1, sizeof(uint32_t));
+    buf->ifindex = calloc(buf->num_pkts + 1, sizeof(iface_index));
+    if (!buf->data || !buf->offsets || !buf->lengths || !buf->ifindex) {
+        perror("Fatal: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < pkt_list->len; i++) {
+        pcap_pkt *pkt = pkt_list->pkts[i];
+        memcpy(buf->data + offset, pkt->data, pkt->pcap_hdr.len);
+        buf->offsets[i] = offset;
+        buf->lengths[i] = pkt->pcap_hdr.len;
+        buf->ifindex[i] = pkt->ifindex;
+        offset += pkt->pcap_hdr.len;
+    }
+    return buf;
+}
+
+void delete_pkt_buffer(pcap_buffer_t *buf) {
+    free(buf->data);
+    free(buf->offsets);
+    free(buf->lengths);
+    free(buf->ifindex);
+    free(buf);
+}
+
 /* Rank packets based on the timestamp of the pcap header */
 static int compare_pkt_time(const void *s1, const void *s2) {
   pcap_pkt *p1 = *(pcap_pkt **)s1;
@@ -32,6 +32,18 @@ struct pcap_list_array;
 typedef struct pcap_list pcap_list_t;
 typedef struct pcap_list_array pcap_list_array_t;
 
+/// A flat, read-only copy of a packet list.
+/// All packet contents are stored back to back in a single buffer, so
+/// iterating over the packets does not chase per-packet allocations.
+typedef struct {
+    char *data;             // contents of all packets
+    uint32_t *offsets;      // start of each packet in data
+    uint32_t *lengths;      // length of each packet
+    iface_index *ifindex;   // interface of each packet
+    uint32_t num_pkts;
+    uint32_t max_len;       // length of the largest packet
+} pcap_buffer_t;
+
 /// Retrieve packets from a pcap file.
 /// Retrieves a list of packets from a given pcap file.
 /// Allocates a packet list and fills it with the packets from the
@@ -170,6 +182,21 @@ void delete_array(pcap_list_array_t *pkt_list_array);
 /// @param pkt_list A list.
 void sort_pcap_list(pcap_list_t *pkt_list);
 
+/// Copies a packet list into a contiguous buffer.
+/// The list is left untouched. A buffer allocated by this function
+/// should subsequently be freed by delete_pkt_buffer().
+///
+/// @param pkt_list A list.
+///
+/// @return The allocated buffer. This function causes an
+/// exit if allocation fails.
+pcap_buffer_t *flatten_pkt_list(pcap_list_t *pkt_list);
+
+/// Deletes a packet buffer and the data it holds.
+///
+/// @param buf A packet buffer.
+void delete_pkt_buffer(pcap_buffer_t *buf);
+
 /// Create a pcap file name from a given base name, interface index,
 /// and suffix. Return value must be deallocated after usage.
 /// @param pcap_base The file base name.
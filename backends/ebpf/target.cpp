@@ -267,6 +267,8 @@ void BccTarget::emitTableDecl(Util::SourceCodeBuilder *builder, cstring tblName,
         kind = "array"_cs;
     else if (tableKind == TableLPMTrie)
         kind = "lpm_trie"_cs;
+    else if (tableKind == TablePerCPUArray)
+        kind = "percpu_array"_cs;
     else
         BUG("%1%: unsupported table kind", tableKind);
 
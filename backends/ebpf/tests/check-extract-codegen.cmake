@@ -0,0 +1,42 @@
+# SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Compiles extract_aligned.p4 with p4c-ebpf and checks the code generated to
+# extract its headers.
+#
+# cmake -DP4C=<p4c-ebpf> -DSOURCE_DIR=<p4c source> -DOUTPUT=<file.c> \
+#       -P check-extract-codegen.cmake
+
+execute_process(
+  COMMAND ${P4C} --Werror --Wdisable=unused -I${SOURCE_DIR}/p4include --target kernel
+          -o ${OUTPUT} ${CMAKE_CURRENT_LIST_DIR}/extract_aligned.p4
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "p4c-ebpf failed: ${result}")
+endif()
+file(READ ${OUTPUT} code)
+
+# Byte-aligned fields are copied without reading past their end, and
+# converted to host byte order in place.
+set (EXPECTED
+  "__builtin_memcpy\\(&[^,]*ethernet\\.destination, [A-Za-z_]+ \\+ BYTES\\(0\\), 6\\)"
+  "ethernet\\.destination = \\(u64\\)\\(bpf_be64_to_cpu\\([^)]*ethernet\\.destination\\) >> 16\\)"
+  "__builtin_memcpy\\(&[^,]*ethernet\\.source, [A-Za-z_]+ \\+ BYTES\\(48\\), 6\\)"
+  "ethernet\\.protocol = \\(u16\\)\\(\\(load_half\\([A-Za-z_]+, BYTES\\(96\\)\\)\\)\\)"
+  "__builtin_memcpy\\(&[^,]*tag\\.id, [A-Za-z_]+ \\+ BYTES\\(0\\), 3\\)"
+  "tag\\.id = \\(u32\\)\\(bpf_ntohl\\([^)]*tag\\.id\\) >> 8\\)"
+  # Unaligned fields are still loaded and masked.
+  "vlan\\.vid = \\(u16\\)\\(\\(load_half\\([A-Za-z_]+, BYTES\\(4\\)\\)\\) & EBPF_MASK\\(u16, 12\\)\\)"
+  # The bounds checks do not require bytes past the headers.
+  "BYTES\\(112 \\+ 0\\)"
+  "BYTES\\(32 \\+ 0\\)"
+)
+foreach (regex ${EXPECTED})
+  if (NOT code MATCHES "${regex}")
+    message(FATAL_ERROR "${OUTPUT} does not match ${regex}")
+  endif()
+endforeach()
+if (code MATCHES "load_dword")
+  message(FATAL_ERROR "${OUTPUT} reads a field with load_dword")
+endif()
@@ -222,6 +222,14 @@ class P4EbpfTest(BaseTest):
         value = [format(int(v, 0), "02x") for v in json.loads(stdout)["value"]]
         return " ".join(value)
 
+    def read_percpu_map(self, name, key):
+        """Returns the bytes of the value of each CPU in an entry of a per-CPU map."""
+        cmd = "bpftool -j map lookup pinned {}/{} key {}".format(
+            PIPELINE_MAPS_MOUNT_PATH, name, key
+        )
+        _, stdout, _ = self.exec_ns_cmd(cmd, "Failed to read map {}".format(name))
+        return [bytes(int(v, 0) for v in cpu["value"]) for cpu in json.loads(stdout)["values"]]
+
     def verify_map_entry(self, name, key, expected_value, mask=None):
         value = self.read_map(name, key)
 
@@ -429,6 +429,39 @@ class CountersPSATest(P4EbpfTest):
         self.counter_verify(name="ingress_action_cnt", key=[DP_PORTS[1]], bytes=299, packets=2)
 
 
+class PerCPUCountersPSATest(P4EbpfTest):
+    """Test indexed counters compiled with --percpu-counters. Each CPU updates its own
+    copy of a counter, so the values of all CPUs are summed up when reading them."""
+
+    p4_file_path = "p4testdata/counters.p4"
+    p4c_additional_args = "--percpu-counters"
+
+    def percpu_counter_verify(self, name, index, width, expected_bytes, expected_packets):
+        """Verifies a PACKETS_AND_BYTES counter with values of @width bytes."""
+        key = "hex " + " ".join(format(b, "02x") for b in index.to_bytes(4, "little"))
+        counter_bytes, counter_packets = 0, 0
+        for value in self.read_percpu_map(name, key):
+            counter_bytes += int.from_bytes(value[0:width], "little")
+            counter_packets += int.from_bytes(value[width : 2 * width], "little")
+        if counter_bytes != expected_bytes or counter_packets != expected_packets:
+            self.fail(
+                "Invalid counter {}[{}], expected {} bytes and {} packets, got {} and {}".format(
+                    name, index, expected_bytes, expected_packets, counter_bytes, counter_packets
+                )
+            )
+
+    def runTest(self):
+        pkt = testutils.simple_ip_packet(
+            eth_dst="00:11:22:33:44:55", eth_src="00:AA:00:00:00:01", pktlen=100
+        )
+        for _ in range(2):
+            testutils.send_packet(self, PORT0, pkt)
+            testutils.verify_packet_any_port(self, pkt, PTF_PORTS)
+
+        self.percpu_counter_verify("ingress_test3_cnt", 1, 4, 200, 2)
+        self.percpu_counter_verify("ingress_action_cnt", DP_PORTS[1], 8, 200, 2)
+
+
 class DirectCountersPSATest(P4EbpfTest):
     p4_file_path = "p4testdata/direct-counters.p4"
 
@@ -717,6 +750,32 @@ class ConstEntryTernaryPSATest(P4EbpfTest):
         testutils.verify_packet(self, pkt, PORT1)
 
 
+class EntriesTernaryPSATest(P4EbpfTest):
+    """
+    Test that an entry added by the control plane outranks the (non-const) entries
+    of a ternary table, even though it is stored in a tuple added after them.
+    """
+
+    p4_file_path = "p4testdata/entries-ternary.p4"
+
+    def runTest(self):
+        pkt = testutils.simple_ip_packet(ip_dst="17.34.51.68")  # 0x11223344
+
+        # via the first of the entries defined in the program
+        testutils.send_packet(self, PORT0, pkt)
+        testutils.verify_packet(self, pkt, PORT1)
+
+        self.table_add(
+            table="ingress_tbl_ternary",
+            key=["0x11223344^0xffffffff"],
+            action=1,
+            data=[DP_PORTS[2]],
+            priority=10,
+        )
+        testutils.send_packet(self, PORT0, pkt)
+        testutils.verify_packet(self, pkt, PORT2)
+
+
 class PassToKernelStackTest(P4EbpfTest):
     p4_file_path = "p4testdata/pass-to-kernel.p4"
 
@@ -40,6 +40,7 @@
 #include "midend/global_copyprop.h"
 #include "midend/hsIndexSimplify.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeTables.h"
 #include "midend/midEndLast.h"
 #include "midend/nestedStructs.h"
 #include "midend/noMatch.h"
@@ -117,6 +118,7 @@ MidEnd::MidEnd(P4TestOptions &options, std::ostream *outStream) {
          }),
          new P4::StrengthReduction(&typeMap),
          new P4::MoveDeclarations(),  // more may have been introduced
+         options.mergeTables ? new P4::MergeTables(&typeMap) : nullptr,
          new P4::SimplifyControlFlow(&typeMap, true),
          new P4::CompileTimeOperations(),
          new P4::TableHit(&typeMap),
@@ -10,6 +10,7 @@
 #include <filesystem>
 
 #include "backend.h"
+#include "backends/ebpf/codeSizeReport.h"
 #include "backends/ebpf/ebpfOptions.h"
 #include "backends/ebpf/target.h"
 #include "ebpfCodeGen.h"
@@ -1852,6 +1853,10 @@ bool Backend::ebpfCodeGen(P4::ReferenceMap *refMapEBPF, P4::TypeMap *typeMapEBPF
     ebpfOption.xdp2tcMode = options.xdp2tcMode;
     ebpfOption.exe_name = options.exe_name;
     ebpfOption.file = options.file;
+    ebpfOption.sizeReportFile = options.sizeReportFile;
+    ebpfOption.maxPathStatements = options.maxPathStatements;
+    ebpfOption.maxPathLookups = options.maxPathLookups;
+    ebpfOption.maxStackBytes = options.maxStackBytes;
     PnaProgramStructure structure(refMapEBPF, typeMapEBPF);
     auto parsePnaArch = new ParsePnaArchitecture(&structure);
     auto main = toplevel->getMain();
@@ -1902,6 +1907,8 @@ bool Backend::ebpfCodeGen(P4::ReferenceMap *refMapEBPF, P4::TypeMap *typeMapEBPF
 
     ebpf_program = convertToEbpf->getEBPFProgram();
 
+    if (!EBPF::estimateCodeSize(ebpfOption, program, refMapEBPF, typeMapEBPF)) return false;
+
     return true;
 }
 
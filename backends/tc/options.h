@@ -23,6 +23,12 @@ class TCOptions : public CompilerOptions {
     // XDP2TC mode for PSA-eBPF
     enum XDP2TC xdp2tcMode = XDP2TC_META;
     unsigned timerProfiles = 4;
+    // file to write the estimated code size report to
+    std::filesystem::path sizeReportFile;
+    // budgets for the estimated code size (0 = unlimited)
+    unsigned maxPathStatements = 0;
+    unsigned maxPathLookups = 0;
+    unsigned maxStackBytes = 0;
 
     TCOptions() {
         registerOption(
@@ -67,6 +73,35 @@ class TCOptions : public CompilerOptions {
                 return true;
             },
             "Defines the number of timer profiles. Default is 4.");
+        registerOption(
+            "--emit-size-report", "file",
+            [this](const char *arg) {
+                sizeReportFile = arg;
+                return true;
+            },
+            "Write the estimated size of the generated eBPF code per parser state, table and "
+            "action to file");
+        registerOption(
+            "--max-path-statements", "N",
+            [this](const char *arg) {
+                maxPathStatements = std::strtoul(arg, nullptr, 0);
+                return true;
+            },
+            "Fail if the estimated number of statements on the worst path exceeds N");
+        registerOption(
+            "--max-path-lookups", "N",
+            [this](const char *arg) {
+                maxPathLookups = std::strtoul(arg, nullptr, 0);
+                return true;
+            },
+            "Fail if the estimated number of map lookups on the worst path exceeds N");
+        registerOption(
+            "--max-stack-bytes", "N",
+            [this](const char *arg) {
+                maxStackBytes = std::strtoul(arg, nullptr, 0);
+                return true;
+            },
+            "Fail if the estimated stack usage of a parser or control exceeds N bytes");
     }
 };
 
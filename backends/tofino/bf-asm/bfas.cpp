@@ -25,6 +25,15 @@
 #include <string>
 #include <vector>
 
+#ifdef MULTITHREAD
+#include <gc/gc.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#endif  // MULTITHREAD
+
 #include "backends/tofino/bf-asm/target.h"
 #include "backends/tofino/bf-p4c/git_sha_version.h"  // for BF_P4C_GIT_SHA
 #include "backends/tofino/bf-p4c/version.h"
@@ -66,6 +75,7 @@ option_t options = {
     .num_stages_override = 0,
     .tof1_egr_parse_depth_checks_disabled = false,
     .fill_noop_slot = nullptr,
+    .output_jobs = 4,
 };
 
 std::string asmfile_name;                       // NOLINT(runtime/string)
@@ -125,6 +135,79 @@ std::unique_ptr<std::ostream> open_output(const char *name, ...) {
     return rv;
 }
 
+#ifdef MULTITHREAD
+/// Threads running the functions passed to write_output_async.  They are started by the first
+/// call and stopped by wait_for_output.
+class OutputWriters {
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> jobs;
+    std::mutex lock;
+    std::condition_variable ready;
+    bool done = false;
+
+    void run() {
+        GC_stack_base sb;
+        GC_get_stack_base(&sb);
+        GC_register_my_thread(&sb);
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ready.wait(guard, [this] { return done || !jobs.empty(); });
+                if (jobs.empty()) break;
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            job();
+        }
+        GC_unregister_my_thread();
+    }
+
+ public:
+    void push(std::function<void()> fn) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (threads.empty()) {
+            static bool init_mt = true;
+            if (init_mt) {
+                GC_allow_register_threads();
+                init_mt = false;
+            }
+            for (int i = 0; i < options.output_jobs; i++)
+                threads.emplace_back(&OutputWriters::run, this);
+        }
+        jobs.push(std::move(fn));
+        ready.notify_one();
+    }
+    void wait() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done = true;
+        }
+        ready.notify_all();
+        for (auto &t : threads) t.join();
+        threads.clear();
+        done = false;
+    }
+    ~OutputWriters() { wait(); }
+} output_writers;
+#endif  // MULTITHREAD
+
+void write_output_async(std::function<void()> fn) {
+#ifdef MULTITHREAD
+    if (options.output_jobs > 1) {
+        output_writers.push(std::move(fn));
+        return;
+    }
+#endif  // MULTITHREAD
+    fn();
+}
+
+void wait_for_output() {
+#ifdef MULTITHREAD
+    output_writers.wait();
+#endif  // MULTITHREAD
+}
+
 std::string usage(std::string tfas) {
     std::string u = "usage: ";
     u.append(tfas);
@@ -166,6 +249,9 @@ void output_all() {
     ctxtJson["configuration_cache"] = json::vector();
 
     Section::output_all(ctxtJson);
+    // The top level condenses and writes the registers of the sections, which must no longer
+    // be read by their .cfg.json output.
+    wait_for_output();
     TopLevel::output_all(ctxtJson);
 
     json::map driver_options;
@@ -300,6 +386,8 @@ int run(int ac, char **av) {
             unique_table_offset = val;
         } else if (sscanf(av[i], "--num-stages-override%d", &val) > 0 && val >= 0) {
             options.num_stages_override = val;
+        } else if (sscanf(av[i], "--output-jobs%d", &val) > 0 && val >= 1) {
+            options.output_jobs = val;
         } else if (!strcmp(av[i], "--target")) {
             ++i;
             if (!av[i]) {
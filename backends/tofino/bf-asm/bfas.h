@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -74,6 +75,7 @@ extern struct option_t {
     int num_stages_override;
     bool tof1_egr_parse_depth_checks_disabled;
     const char *fill_noop_slot;
+    int output_jobs;
 } options;
 
 extern unsigned unique_action_handle;
@@ -122,6 +124,13 @@ inline void warning(int lineno, const char *fmt, ...) {
 extern std::unique_ptr<std::ostream> open_output(const char *, ...)
     __attribute__((format(printf, 1, 2)));
 
+/// Runs @p fn, which writes output files, on one of options.output_jobs threads when bfas is
+/// built with multithreading, and immediately otherwise.  @p fn may only read data that is no
+/// longer modified until wait_for_output() returns.
+void write_output_async(std::function<void()> fn);
+/// Waits for the completion of all the functions passed to write_output_async.
+void wait_for_output();
+
 class VersionIter {
     unsigned left, bit;
     void check() {
@@ -18,18 +18,77 @@
 #ifndef BACKENDS_TOFINO_BF_ASM_BINARY_OUTPUT_H_
 #define BACKENDS_TOFINO_BF_ASM_BINARY_OUTPUT_H_
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <streambuf>
+#include <vector>
 
 namespace binout {
 
+/// Register images are made of millions of records of a few bytes, so they are written straight
+/// to the stream buffer instead of through std::ostream::write, which sets up a sentry for
+/// each of them.
+inline std::ostream &write(std::ostream &out, const char *data, std::streamsize size) {
+    if (out.rdbuf()->sputn(data, size) != size) out.setstate(std::ios::badbit);
+    return out;
+}
+
+/// Stream that collects what is written to it in a large buffer, and passes it to another
+/// stream in big blocks.
+class buffered_ostream : public std::ostream {
+    class buffer_t : public std::streambuf {
+        std::ostream &out;
+        std::vector<char> data;
+
+        bool flush_data() {
+            std::streamsize size = pptr() - pbase();
+            setp(data.data(), data.data() + data.size());
+            return out.rdbuf()->sputn(data.data(), size) == size;
+        }
+
+     public:
+        buffer_t(std::ostream &out, size_t size) : out(out), data(size) {
+            setp(data.data(), data.data() + data.size());
+        }
+        int sync() override { return flush_data() && out.rdbuf()->pubsync() == 0 ? 0 : -1; }
+        int_type overflow(int_type c) override {
+            if (!flush_data()) return traits_type::eof();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+        std::streamsize xsputn(const char *s, std::streamsize n) override {
+            if (n <= epptr() - pptr()) {
+                memcpy(pptr(), s, n);
+                pbump(n);
+                return n;
+            }
+            if (!flush_data()) return 0;
+            if (n >= epptr() - pptr()) return out.rdbuf()->sputn(s, n);
+            memcpy(pptr(), s, n);
+            pbump(n);
+            return n;
+        }
+    } buffer;
+
+ public:
+    explicit buffered_ostream(std::ostream &out, size_t size = 1 << 20)
+        : std::ostream(&buffer), buffer(out, size) {
+        init(&buffer);
+    }
+    ~buffered_ostream() { flush(); }
+};
+
 class tag {
     char data[4] = {0, 0, 0, 0};
 
  public:
     tag(char ch) { data[3] = ch; }  // NOLINT(runtime/explicit)
     friend std::ostream &operator<<(std::ostream &out, const tag &e) {
-        return out.write(e.data, 4);
+        return write(out, e.data, 4);
     }
 };
 
@@ -44,7 +103,7 @@ class byte4 {
         data[3] = (v >> 24) & 0xff;
     }
     friend std::ostream &operator<<(std::ostream &out, const byte4 &e) {
-        return out.write(e.data, 4);
+        return write(out, e.data, 4);
     }
 };
 
@@ -63,7 +122,7 @@ class byte8 {
         data[7] = (v >> 56) & 0xff;
     }
     friend std::ostream &operator<<(std::ostream &out, const byte8 &e) {
-        return out.write(e.data, 8);
+        return write(out, e.data, 8);
     }
 };
 
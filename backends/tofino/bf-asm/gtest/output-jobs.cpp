@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.  You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the
+ * License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.  See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "backends/tofino/bf-asm/bfas.h"
+#include "backends/tofino/bf-asm/target.h"
+
+namespace {
+
+/* Tests for --output-jobs
+ *
+ * The same registers are emitted to several streams through write_output_async, so with
+ * more than one job they are read by several threads at the same time.
+ */
+
+std::vector<std::string> emitWithJobs(const Target::Tofino::mau_regs &regs, int jobs) {
+    auto saved_jobs = options.output_jobs;
+    options.output_jobs = jobs;
+    std::vector<std::ostringstream> out(4);
+    for (auto &o : out) write_output_async([&regs, &o]() { regs.emit_json(o, 0); });
+    wait_for_output();
+    options.output_jobs = saved_jobs;
+
+    std::vector<std::string> rv;
+    for (auto &o : out) rv.push_back(o.str());
+    return rv;
+}
+
+TEST(OutputJobs, ConcurrentOutputMatchesSerial) {
+    auto regs = std::make_unique<Target::Tofino::mau_regs>();
+    regs->dp.cur_stage_dependency_on_prev[INGRESS] = 1;
+    regs->dp.next_stage_dependency_on_cur[EGRESS] = 2;
+
+    auto serial = emitWithJobs(*regs, 1);
+    auto concurrent = emitWithJobs(*regs, 4);
+    ASSERT_FALSE(serial.front().empty());
+    for (auto &s : serial) EXPECT_EQ(s, serial.front());
+    for (auto &c : concurrent) EXPECT_EQ(c, serial.front());
+}
+
+}  // namespace
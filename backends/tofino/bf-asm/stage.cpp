@@ -20,6 +20,7 @@
 #include <time.h>
 
 #include <fstream>
+#include <string>
 
 #include "backends/tofino/bf-asm/config.h"
 #include "backends/tofino/bf-asm/target.h"
@@ -712,14 +713,21 @@ void Stage::output(json::map &ctxt_json, bool egress_only) {
     char buf[64];
     snprintf(buf, sizeof(buf), "regs.match_action_stage%s.%02x", egress_only ? ".egress" : "",
              stageno);
-    if (error_count == 0 && options.gen_json)
-        regs->emit_json(*open_output("%s.cfg.json", buf), stageno);
+    bool emit_cfg_json = error_count == 0 && options.gen_json;
     auto NUM_STAGES = egress_only ? Target::NUM_EGRESS_STAGES() : Target::NUM_MAU_STAGES();
     if (stageno < NUM_STAGES) TopLevel::all->set_mau_stage(stageno, buf, regs, egress_only);
     gen_mau_stage_characteristics(*regs, ctxt_json["mau_stage_characteristics"]);
     gen_configuration_cache(*regs, ctxt_json["configuration_cache"]);
     if (stageno == NUM_STAGES - 1 && Target::OUTPUT_STAGE_EXTENSION())
         gen_mau_stage_extension(*regs, ctxt_json["mau_stage_extension"]);
+
+    // The registers of the stage are complete; write them while the next stages are output.
+    if (emit_cfg_json) {
+        std::string file = std::string(buf) + ".cfg.json";
+        write_output_async([regs, file, stageno = stageno]() {
+            regs->emit_json(*open_output("%s", file.c_str()), stageno);
+        });
+    }
 }
 
 template <class REGS>
@@ -82,13 +82,19 @@ void TopLevelRegs<TARGET>::output(json::map &ctxt_json) {
     }
     if (error_count == 0) {
         if (options.gen_json) {
-            this->mem_top.emit_json(*open_output("memories.top.cfg.json"));
-            this->mem_pipe.emit_json(*open_output("memories.pipe.cfg.json"));
-            this->reg_top.emit_json(*open_output("regs.top.cfg.json"));
-            this->reg_pipe.emit_json(*open_output("regs.pipe.cfg.json"));
+            write_output_async(
+                [this]() { this->mem_top.emit_json(*open_output("memories.top.cfg.json")); });
+            write_output_async(
+                [this]() { this->mem_pipe.emit_json(*open_output("memories.pipe.cfg.json")); });
+            write_output_async(
+                [this]() { this->reg_top.emit_json(*open_output("regs.top.cfg.json")); });
+            write_output_async(
+                [this]() { this->reg_pipe.emit_json(*open_output("regs.pipe.cfg.json")); });
+            wait_for_output();
         }
         if (options.binary != NO_BINARY) {
-            auto binfile = open_output("%s.bin", TARGET::name);
+            auto binfile_out = open_output("%s.bin", TARGET::name);
+            binout::buffered_ostream binfile(*binfile_out);
             json::map header;
             header["asm_version"] = BFASM::Version::getVersion();
             if (ctxt_json["compiler_version"])
@@ -99,17 +105,17 @@ void TopLevelRegs<TARGET>::output(json::map &ctxt_json) {
                 header["program_name"] = ctxt_json["program_name"]->clone();
             header["target"] = Target::name();
             header["stages"] = Target::NUM_MAU_STAGES();
-            *binfile << binout::tag('H') << json::binary(header);
+            binfile << binout::tag('H') << json::binary(header);
             if (options.binary != ONE_PIPE) {
-                this->mem_top.emit_binary(*binfile, 0);
-                this->reg_top.emit_binary(*binfile, 0);
+                this->mem_top.emit_binary(binfile, 0);
+                this->reg_top.emit_binary(binfile, 0);
             } else {
-                this->mem_pipe.emit_binary(*binfile, 0);
-                this->reg_pipe.emit_binary(*binfile, 0);
+                this->mem_pipe.emit_binary(binfile, 0);
+                this->reg_pipe.emit_binary(binfile, 0);
             }
 
             if (options.multi_parsers) {
-                emit_parser_registers(this, *binfile);
+                emit_parser_registers(this, binfile);
             }
         }
     }
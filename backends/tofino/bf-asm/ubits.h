@@ -22,6 +22,7 @@
 #include <limits.h>
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <sstream>
@@ -48,9 +49,12 @@ struct ubits_base {
     explicit ubits_base(uint64_t v)
         : value(v), reset_value(v), read(false), write(false), disabled_(false) {}
     operator uint64_t() const {
-        read = true;
+        mark_read();
         return value;
     }
+    /// Registers are read by the concurrent writers of write_output_async, so the read flag
+    /// is set atomically.
+    void mark_read() const { std::atomic_ref<bool>(read).store(true, std::memory_order_relaxed); }
     bool modified() const { return write; }
     void set_modified(bool v = true) { write = v; }
     bool disabled() const { return disabled_; }
@@ -108,12 +112,12 @@ struct ubits : ubits_base {
     }
     const ubits &operator=(const ubits &v) {
         *this = v.value;
-        v.read = true;
+        v.mark_read();
         return v;
     }
     const ubits_base &operator=(const ubits_base &v) {
         *this = v.value;
-        v.read = true;
+        v.mark_read();
         return v;
     }
     unsigned size() override { return N; }
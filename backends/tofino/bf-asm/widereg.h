@@ -20,6 +20,7 @@
 
 #include <limits.h>
 
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <sstream>
@@ -51,9 +52,11 @@ struct widereg_base {
     explicit widereg_base(int v)
         : value(v), reset_value(v), read(false), write(false), disabled_(false) {}
     operator bitvec() const {
-        read = true;
+        mark_read();
         return value;
     }
+    /// Set atomically, see ubits_base::mark_read.
+    void mark_read() const { std::atomic_ref<bool>(read).store(true, std::memory_order_relaxed); }
     bool modified() const { return write; }
     void set_modified(bool v = true) { write = v; }
     bool disabled() const { return disabled_; }
@@ -129,12 +132,12 @@ struct widereg : widereg_base {
     }
     const widereg &operator=(const widereg &v) {
         *this = v.value;
-        v.read = true;
+        v.mark_read();
         return v;
     }
     const widereg_base &operator=(const widereg_base &v) {
         *this = v.value;
-        v.read = true;
+        v.mark_read();
         return v;
     }
     unsigned size() { return N; }
@@ -349,6 +349,27 @@ BFN_Options::BFN_Options() {
             return true;
         },
         "Do not backfill tables in table placement");
+#ifdef MULTITHREAD
+    registerOption(
+        "--table-placement-jobs", "n",
+        [this](const char *arg) {
+            std::string argStr(arg);
+            std::size_t end = 0;
+            int tmp = 0;
+            try {
+                tmp = std::stoi(argStr, &end);
+            } catch (...) {
+                end = 0;
+            }
+            if (end != argStr.size() || tmp <= 0) {
+                ::error("Invalid number of table placement jobs %s. Enter positive integer.", arg);
+                return false;
+            }
+            table_placement_jobs = tmp;
+            return true;
+        },
+        "Number of worker threads evaluating table placement choices in parallel (default 4)");
+#endif
     registerOption(
         "--disable_split_attached", nullptr,
         [this](const char *) {
@@ -524,6 +545,16 @@ BFN_Options::BFN_Options() {
         "Enable Metadata Initialization for alternative PHV allocation ordering(--alt-phv-alloc)",
         OptionFlags::Hide);
 #endif
+    registerOption(
+        "--disable-phv-slicing-reuse", nullptr,
+        [this](const char *) {
+            disable_phv_slicing_reuse = true;
+            return true;
+        },
+        "Allocate every slicing of a super cluster from scratch in the alternative PHV "
+        "allocation (--alt-phv-alloc), instead of reusing the prefix shared with the previous "
+        "slicing",
+        OptionFlags::Hide);
     registerOption(
         "--traffic-limit", "arg",
         [this](const char *arg) {
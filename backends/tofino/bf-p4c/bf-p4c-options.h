@@ -55,6 +55,9 @@ class BFN_Options : public CompilerOptions {
     bool disable_egress_latency_padding = false;
     bool table_placement_in_order = false;
     bool table_placement_long_branch_backtrack = false;
+#ifdef MULTITHREAD
+    int table_placement_jobs = 4;
+#endif
     bool disable_gfm_parity = true;
     int relax_phv_init = 0;
     bool quick_phv_alloc = false;
@@ -69,6 +72,7 @@ class BFN_Options : public CompilerOptions {
     bool disable_parse_min_depth_limit = false;
     bool disable_parse_max_depth_limit = false;
     bool alt_phv_alloc_meta_init = false;
+    bool disable_phv_slicing_reuse = false;
 #if BAREFOOT_INTERNAL || 1
     // FIXME -- Cmake does not consistently set BAREFOOT_INTERNAL for all source
     // files (why?), so having the layout of any class depend on it will result in
@@ -1345,6 +1345,33 @@ void DependencyGraph::fill_dep_stages_from_topo(
     }
 }
 
+void DependencyGraph::build_happens_rows() {
+    happens_id.clear();
+    typename Graph::vertex_iterator v, v_end;
+    for (boost::tie(v, v_end) = boost::vertices(g); v != v_end; ++v)
+        happens_id.emplace(get_vertex(*v), happens_id.size());
+
+    auto build = [this](const ordered_map<const IR::MAU::Table *,
+                                          ordered_set<const IR::MAU::Table *>> &map,
+                        std::vector<bitvec> &rows) {
+        rows.assign(happens_id.size(), bitvec());
+        for (auto &kv : map) {
+            auto id = happens_id.find(kv.first);
+            if (id == happens_id.end()) continue;
+            auto &row = rows[id->second];
+            for (auto *tbl : kv.second) {
+                auto tbl_id = happens_id.find(tbl);
+                if (tbl_id != happens_id.end()) row.setbit(tbl_id->second);
+            }
+        }
+    };
+    build(happens_phys_before_map, happens_phys_before_rows);
+    build(happens_phys_after_map, happens_phys_after_rows);
+    build(happens_before_control_map, happens_before_control_rows);
+    build(happens_logi_before_map, happens_logi_before_rows);
+    build(happens_logi_after_map, happens_logi_after_rows);
+}
+
 bool DependencyGraph::is_anti_edge(DependencyGraph::dependencies_t dep) const {
     return (dep == DependencyGraph::ANTI_EXIT || dep == DependencyGraph::ANTI_TABLE_READ ||
             dep == DependencyGraph::ANTI_ACTION_READ ||
@@ -2369,6 +2396,8 @@ void FindDependencyGraph::finalize_dependence_graph(void) {
         }
     }
 
+    dg.build_happens_rows();
+
     verify_dependence_graph();
     if (LOGGING(4)) DependencyGraph::dump_viz(std::cout, dg);
     calc_max_min_stage();
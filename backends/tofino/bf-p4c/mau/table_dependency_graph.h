@@ -22,6 +22,8 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/transitive_closure.hpp>
@@ -161,6 +163,15 @@ struct DependencyGraph {
         if (!finalized) BUG("Dependency graph used before being fully constructed.");
     }
 
+    bool happens_test(const std::vector<bitvec> &rows, const IR::MAU::Table *t1,
+                      const IR::MAU::Table *t2) const {
+        auto id1 = happens_id.find(t1);
+        if (id1 == happens_id.end() || size_t(id1->second) >= rows.size()) return false;
+        auto id2 = happens_id.find(t2);
+        if (id2 == happens_id.end()) return false;
+        return rows[id1->second][id2->second];
+    }
+
     void check_stage_info_exist(const IR::MAU::Table *t) const {
         if (!stage_info.count(t)) {
             BUG("table not exists in Dependency graph: %1%", cstring::to_cstring(t));
@@ -229,6 +240,17 @@ struct DependencyGraph {
     ordered_map<const IR::MAU::Table *, ordered_set<const IR::MAU::Table *>>
         happens_logi_before_map;
 
+    // Dense versions of the happens_*_map above, for the pairwise queries issued by table
+    // placement: row happens_phys_before_rows[id(t1)] has bit id(t2) set iff t2 is in
+    // happens_phys_before_map[t1], where id() is given by happens_id.  Built from the maps by
+    // build_happens_rows once the graph is finalized.
+    std::unordered_map<const IR::MAU::Table *, int> happens_id;
+    std::vector<bitvec> happens_phys_before_rows;
+    std::vector<bitvec> happens_phys_after_rows;
+    std::vector<bitvec> happens_before_control_rows;
+    std::vector<bitvec> happens_logi_before_rows;
+    std::vector<bitvec> happens_logi_after_rows;
+
     ordered_map<const IR::MAU::Table *, ordered_map<const IR::MAU::Table *, dependencies_t>>
         dep_type_map;
 
@@ -308,6 +330,12 @@ struct DependencyGraph {
         happens_before_control_map.clear();
         happens_logi_after_map.clear();
         happens_logi_before_map.clear();
+        happens_id.clear();
+        happens_phys_before_rows.clear();
+        happens_phys_after_rows.clear();
+        happens_before_control_rows.clear();
+        happens_logi_before_rows.clear();
+        happens_logi_after_rows.clear();
         dep_type_map.clear();
         labelToVertex.clear();
         dependency_map.clear();
@@ -415,20 +443,12 @@ struct DependencyGraph {
 
     bool happens_phys_before(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_phys_before_map.count(t1)) {
-            return happens_phys_before_map.at(t1).count(t2);
-        } else {
-            return false;
-        }
+        return happens_test(happens_phys_before_rows, t1, t2);
     }
 
     bool happens_phys_after(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_phys_after_map.count(t1)) {
-            return happens_phys_after_map.at(t1).count(t2);
-        } else {
-            return false;
-        }
+        return happens_test(happens_phys_after_rows, t1, t2);
     }
 
     // returns true if any table in s or control dependent on a table in s is
@@ -445,7 +465,7 @@ struct DependencyGraph {
     bool happens_phys_before_recursive(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
         if (happens_phys_before_map.count(t1)) {
-            if (t2 != t1 && happens_phys_before_map.at(t1).count(t2)) return true;
+            if (t2 != t1 && happens_test(happens_phys_before_rows, t1, t2)) return true;
             for (auto *next : Values(t2->next))
                 if (happens_phys_before_recursive(t1, next)) return true;
         }
@@ -454,28 +474,22 @@ struct DependencyGraph {
 
     bool happens_before_control(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_before_control_map.count(t1))
-            return happens_before_control_map.at(t1).count(t2);
-        else
-            return false;
+        return happens_test(happens_before_control_rows, t1, t2);
     }
 
     bool happens_logi_before(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_logi_before_map.count(t1))
-            return happens_logi_before_map.at(t1).count(t2);
-        else
-            return false;
+        return happens_test(happens_logi_before_rows, t1, t2);
     }
 
     bool happens_logi_after(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_logi_after_map.count(t1))
-            return happens_logi_after_map.at(t1).count(t2);
-        else
-            return false;
+        return happens_test(happens_logi_after_rows, t1, t2);
     }
 
+    /// Fill happens_id and the happens_*_rows from the happens_*_maps.
+    void build_happens_rows();
+
     std::optional<ordered_map<const PHV::Field *, std::pair<ordered_set<const IR::MAU::Action *>,
                                                             ordered_set<const IR::MAU::Action *>>>>
     get_data_dependency_info(typename Graph::edge_descriptor edge) const {
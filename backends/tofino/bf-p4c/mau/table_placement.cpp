@@ -25,14 +25,17 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <tuple>
 #include <vector>
 #endif
 #include <algorithm>
 #include <list>
+#include <optional>
 #include <sstream>
 #include <unordered_map>
 
@@ -363,6 +366,10 @@ Visitor::profile_t TablePlacement::init_apply(const IR::Node *root) {
     auto rv = PassManager::init_apply(root);
     alloc_done = phv.alloc_done();
     summary.clearPlacementErrors();
+    mem_alloc_cache.clear();
+    ixbar_failure_cache.clear();
+    mem_alloc_cache_hits = mem_alloc_cache_misses = 0;
+    ixbar_failure_cache_hits = ixbar_failure_cache_misses = 0;
     LOG1("Table Placement " << summary.getActualStateStr()
                             << (ignoreContainerConflicts ? "," : ", not")
                             << " ignoring container conflicts");
@@ -379,6 +386,14 @@ Visitor::profile_t TablePlacement::init_apply(const IR::Node *root) {
     return rv;
 }
 
+void TablePlacement::end_apply() {
+    LOG1("Table Placement memory allocation cache: " << mem_alloc_cache_hits << " hits, "
+                                                      << mem_alloc_cache_misses << " misses");
+    LOG1("Table Placement ixbar failure cache: " << ixbar_failure_cache_hits << " hits, "
+                                                  << ixbar_failure_cache_misses << " misses");
+    placement_round++;
+}
+
 class TablePlacement::SetupInfo : public Inspector {
     TablePlacement &self;
     bool preorder(const IR::MAU::Table *tbl) override {
@@ -2001,18 +2016,88 @@ struct TablePlacement::RewriteForSplitAttached : public Transform {
     }
 };
 
+/**
+ * Canonical description of everything the input xbar and memory allocation of @p tables
+ * depend on: the tables and their gateways, stage, layout choices, entries, attached entries
+ * and current input xbar allocation.  Tables and attached tables are identified by their address,
+ * so the key is only valid during a round of placement.
+ */
+std::string TablePlacement::resource_key(const std::vector<Placed *> &tables) const {
+    std::stringstream key;
+    for (auto *p : tables) {
+        key << p->table << ' ' << p->gw << ' ' << p->stage << ' ' << p->entries << ' '
+            << p->stage_split << ' ' << p->use.format_type;
+        if (auto *lo = p->use.preferred()) {
+            key << ' ' << *lo << ' ' << lo->entries << ' ' << lo->srams << ' ' << lo->maprams << ' '
+                << lo->tcams << ' ' << lo->lambs << ' ' << lo->local_tinds << ' '
+                << lo->select_bus_split << ' ' << lo->action_format_index;
+            for (auto sz : lo->way_sizes) key << " w" << sz;
+            for (auto sz : lo->partition_sizes) key << " p" << sz;
+            for (auto sz : lo->dleft_hash_sizes) key << " d" << sz;
+        }
+        for (auto &ae : p->attached_entries)
+            key << " [" << ae.first << ' ' << ae.second.entries << ' ' << ae.second.need_more
+                << ae.second.first_stage << ']';
+        for (auto *use : {p->resources.match_ixbar.get(), p->resources.gateway_ixbar.get(),
+                          p->resources.proxy_hash_ixbar.get(), p->resources.action_ixbar.get(),
+                          p->resources.selector_ixbar.get(), p->resources.salu_ixbar.get(),
+                          p->resources.meter_ixbar.get()}) {
+            key << " {";
+            if (use) key << *use;
+            key << '}';
+        }
+        key << '\n';
+    }
+    return key.str();
+}
+
 bool TablePlacement::try_alloc_ixbar(Placed *next, std::vector<Placed *> allocated_layout) {
     Log::TempIndent indent;
     LOG5("Trying to allocate ixbar for " << next->name << indent);
     next->resources.clear_ixbar();
     std::unique_ptr<IXBar> current_ixbar(IXBar::create());
     int tables_already_in_stage = 0;
+    std::vector<Placed *> key_tables;
     for (auto *p : boost::adaptors::reverse(allocated_layout)) {
         // TODO: SCM or ternary is shared across both gress
         if (!Device::threadsSharePipe(p->table->gress, next->table->gress)) continue;
-        current_ixbar->update(p->table, &p->resources);
+        key_tables.push_back(p);
         tables_already_in_stage++;
     }
+    key_tables.push_back(next);
+
+    auto fail = [&](cstring failure_reason) {
+        next->resources.clear_ixbar();
+        error_message = "The table " + next->table->name +
+                        " could not fit within the "
+                        "input crossbar";
+        if (tables_already_in_stage)
+            error_message += " with " + std::to_string(tables_already_in_stage) + " other tables";
+        else
+            error_message += " by itself";
+        if (failure_reason) error_message += ": " + failure_reason;
+        LOG3("    " << error_message);
+        return false;
+    };
+
+    // The same allocation failed before; allocations that succeed are not cached, as
+    // they update the resources of the table.
+    std::string key = resource_key(key_tables);
+    {
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> guard(resource_cache_mutex);
+#endif
+        auto cached = ixbar_failure_cache.find(key);
+        if (cached != ixbar_failure_cache.end()) {
+            ixbar_failure_cache_hits++;
+            LOG5("ixbar allocation of the same stage contents failed before");
+            return fail(cached->second);
+        }
+        ixbar_failure_cache_misses++;
+    }
+
+    for (auto *p : key_tables)
+        if (p != next) current_ixbar->update(p->table, &p->resources);
     current_ixbar->add_collisions();
 
     const ActionData::Format::Use *action_format = next->use.preferred_action_format();
@@ -2032,17 +2117,14 @@ bool TablePlacement::try_alloc_ixbar(Placed *next, std::vector<Placed *> allocat
 
     if (!current_ixbar->allocTable(table, next->gw, phv, next->resources, next->use.preferred(),
                                    action_format, next->attached_entries)) {
-        next->resources.clear_ixbar();
-        error_message = "The table " + next->table->name +
-                        " could not fit within the "
-                        "input crossbar";
-        if (tables_already_in_stage)
-            error_message += " with " + std::to_string(tables_already_in_stage) + " other tables";
-        else
-            error_message += " by itself";
-        if (current_ixbar->failure_reason) error_message += ": " + current_ixbar->failure_reason;
-        LOG3("    " << error_message);
-        return false;
+        cstring failure_reason = current_ixbar->failure_reason;
+        {
+#ifdef MULTITHREAD
+            std::lock_guard<std::mutex> guard(resource_cache_mutex);
+#endif
+            ixbar_failure_cache.emplace(std::move(key), failure_reason);
+        }
+        return fail(failure_reason);
     }
 
     LOG5("Allocating ixbar successful");
@@ -2071,28 +2153,73 @@ bool TablePlacement::try_alloc_mem(Placed *next, std::vector<Placed *> whole_sta
 
     if (shrink_lt) current_mem->shrink_allowed_lts();
 
-    const IR::MAU::Table *table_to_add = nullptr;
+    std::vector<Placed *> key_tables;
     for (auto *p : whole_stage) {
         if (!Device::threadsSharePipe(p->table->gress, next->table->gress)) continue;
-        table_to_add = p->table;
-        if (!p->use.format_type.matchThisStage())
-            table_to_add = table_to_add->apply(RewriteForSplitAttached(*this, p));
         BUG_CHECK(p != next && p->stage == next->stage, "invalid whole_stage");
-        // Always Run Tables cannot be counted in the logical table check
-        current_mem->add_table(table_to_add, p->gw, &p->resources, p->use.preferred(),
-                               p->use.preferred_action_format(), p->use.format_type, p->entries,
-                               p->stage_split, p->attached_entries);
-        p->resources.memuse.clear();
-    }
-    table_to_add = next->table;
-    if (!next->use.format_type.matchThisStage())
-        table_to_add = table_to_add->apply(RewriteForSplitAttached(*this, next));
-    current_mem->add_table(table_to_add, next->gw, &next->resources, next->use.preferred(),
-                           next->use.preferred_action_format(), next->use.format_type,
-                           next->entries, next->stage_split, next->attached_entries);
-    next->resources.memuse.clear();
-
-    if (!current_mem->allocate_all()) {
+        key_tables.push_back(p);
+    }
+    key_tables.push_back(next);
+    std::string key = (shrink_lt ? "shrink_lt\n" : "") + resource_key(key_tables);
+
+    bool fits;
+    cstring failure;
+    std::optional<MemAllocResult> cached;
+    {
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> guard(resource_cache_mutex);
+#endif
+        auto it = mem_alloc_cache.find(key);
+        if (it != mem_alloc_cache.end()) {
+            mem_alloc_cache_hits++;
+            cached = it->second;
+        } else {
+            mem_alloc_cache_misses++;
+        }
+    }
+    if (cached) {
+        LOG5("memory allocation of the same stage contents was done before");
+        fits = cached->fits;
+        failure = cached->failure;
+        if (fits) {
+            for (size_t i = 0; i < key_tables.size(); ++i)
+                key_tables[i]->resources.memuse = cached->memuse[i];
+        }
+    } else {
+        for (auto *p : key_tables) {
+            auto *table_to_add = p->table;
+            if (!p->use.format_type.matchThisStage())
+                table_to_add = table_to_add->apply(RewriteForSplitAttached(*this, p));
+            // Always Run Tables cannot be counted in the logical table check
+            current_mem->add_table(table_to_add, p->gw, &p->resources, p->use.preferred(),
+                                   p->use.preferred_action_format(), p->use.format_type,
+                                   p->entries, p->stage_split, p->attached_entries);
+            p->resources.memuse.clear();
+        }
+
+        fits = current_mem->allocate_all();
+        failure = current_mem->last_failure();
+        MemAllocResult result{fits, {}, failure};
+        if (fits) {
+            std::unique_ptr<Memories> verify_mem(Memories::create());
+            if (shrink_lt) verify_mem->shrink_allowed_lts();
+            for (auto *p : key_tables) {
+                verify_mem->update(p->resources.memuse);
+                result.memuse.push_back(p->resources.memuse);
+            }
+            LOG7(IndentCtl::indent << IndentCtl::indent);
+            LOG7(*current_mem << IndentCtl::unindent << IndentCtl::unindent);
+        } else {
+            LOG3("Memuse for failed memory placement: ");
+            LOG3(*current_mem);
+        }
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> guard(resource_cache_mutex);
+#endif
+        mem_alloc_cache.emplace(std::move(key), std::move(result));
+    }
+
+    if (!fits) {
         error_message = next->table->toString() + " could not fit in stage " +
                         std::to_string(next->stage) + " with " + std::to_string(next->entries) +
                         " entries";
@@ -2111,21 +2238,13 @@ bool TablePlacement::try_alloc_mem(Placed *next, std::vector<Placed *> whole_sta
             }
         }
         LOG3("    " << error_message);
-        LOG3("    " << current_mem->last_failure());
-        next->stage_advance_log = "ran out of memories: " + current_mem->last_failure();
-        LOG3("Memuse for failed memory placement: ");
-        LOG3(*current_mem);
+        LOG3("    " << failure);
+        next->stage_advance_log = "ran out of memories: " + failure;
         next->resources.memuse.clear();
         for (auto *p : whole_stage) p->resources.memuse.clear();
         return false;
     }
 
-    std::unique_ptr<Memories> verify_mem(Memories::create());
-    if (shrink_lt) verify_mem->shrink_allowed_lts();
-    for (auto *p : whole_stage) verify_mem->update(p->resources.memuse);
-    verify_mem->update(next->resources.memuse);
-    LOG7(IndentCtl::indent << IndentCtl::indent);
-    LOG7(*current_mem << IndentCtl::unindent << IndentCtl::unindent);
     LOG5("\t Allocating mem successful");
     return true;
 }
@@ -3008,7 +3127,7 @@ TablePlacement::Placed *TablePlacement::try_place_table(Placed *rv, const StageU
  */
 TablePlacement::Placed *DecidePlacement::try_backfill_table(const Placed *done,
                                                             const IR::MAU::Table *tbl,
-                                                            cstring before) {
+                                                            cstring before) const {
     LOG2("try to backfill " << tbl->name << " before " << before);
     std::vector<Placed *> whole_stage;
     Placed *place_before = nullptr;
@@ -3055,16 +3174,29 @@ TablePlacement::Placed *DecidePlacement::try_backfill_table(const Placed *done,
     }
     pl->placed[self.uid(tbl)] = 1;
     pl->match_placed[self.uid(tbl)] = 1;
-    auto tbl_log_str = pl->table ? pl->name + " ( " + pl->table->externalName() + " ) " : pl->name;
-    auto gw_log_str =
-        pl->gw ? " (with gw " + pl->gw->name + ", result tag " + pl->gw_result_tag + ")" : "";
-    LOG1("placing " << pl->entries << " entries of " << tbl_log_str << gw_log_str << " in stage "
-                    << pl->stage << "(" << hex(pl->logical_id) << ") " << pl->use.format_type
-                    << " (backfilled)");
     BUG_CHECK(pl->table->next.empty(), "Can't backfill table with control dependencies");
     return whole_stage.front();
 }
 
+/**
+ * Log the placement of @p tbl in the stage returned by try_backfill_table.  This is done by
+ * the caller once a candidate is selected, as the candidates may be evaluated in parallel.
+ */
+void DecidePlacement::log_backfilled(const Placed *backfilled, const IR::MAU::Table *tbl) const {
+    if (!LOGGING(1)) return;
+    for (auto *pl = backfilled; pl && pl->stage == backfilled->stage; pl = pl->prev) {
+        if (pl->table != tbl) continue;
+        auto tbl_log_str =
+            pl->table ? pl->name + " ( " + pl->table->externalName() + " ) " : pl->name;
+        auto gw_log_str =
+            pl->gw ? " (with gw " + pl->gw->name + ", result tag " + pl->gw_result_tag + ")" : "";
+        LOG1("placing " << pl->entries << " entries of " << tbl_log_str << gw_log_str
+                        << " in stage " << pl->stage << "(" << hex(pl->logical_id) << ") "
+                        << pl->use.format_type << " (backfilled)");
+        return;
+    }
+}
+
 /**
  * In Tofino specifically, if a table is in ingress or egress, then a table for that pipeline
  * must be placed within stage 0.  The parser requires a pathway into the first stage.
@@ -3832,6 +3964,10 @@ std::optional<DecidePlacement::BacktrackPlacement *> DecidePlacement::find_backt
  * with the exact same order as initially requested. The idea is to have the exact same result
  * with or without parallel evaluation.
  *
+ * The same worker threads also evaluate the tables that could be backfilled into the current
+ * stage; the first one that fits, in backfill order, is chosen as in the sequential search.
+ * The number of worker threads is set with the "--table-placement-jobs" option.
+ *
  * The multithreading code can be enabled by defining "ENABLE_MULTITHREAD",
  * e.g. "-DENABLE_MULTITHREAD=ON" when calling the "bootstrap_bfn_compilers.sh" step. This variable
  * is also used in the P4C Frontend to make sure logging is thread safe.
@@ -3858,22 +3994,13 @@ class DecidePlacement::TryPlacedPool {
     std::condition_variable_any queue_CV;
     std::mutex queue_mutex;
 
-    // Carry all the information needed to evaluate a table.
-    struct request_arg {
-        const IR::MAU::Table *t;
-        const Placed *done;
-        const StageUseEstimate &current;
-        TablePlacement::GatewayMergeChoices *gmc;
-        const GroupPlace *group;
-
-        request_arg(const IR::MAU::Table *t, const Placed *done, const StageUseEstimate &current,
-                    TablePlacement::GatewayMergeChoices *gmc, const GroupPlace *group)
-            : t(t), done(done), current(current), gmc(gmc), group(group) {}
-    };
-    std::queue<std::pair<int, struct request_arg *>> work_queue;
+    // Each request is an evaluation bound to its arguments, which stores its result under
+    // the request ID.
+    std::queue<std::pair<int, std::function<void(int)>>> work_queue;
     std::condition_variable_any res_CV;
     std::mutex res_mutex;
     std::map<int, std::pair<safe_vector<TablePlacement::Placed *>, const GroupPlace *>> work_result;
+    std::map<int, std::pair<const IR::MAU::Table *, const Placed *>> backfill_result;
 
     int num_req = 0;
     int exe_req = 0;
@@ -3886,6 +4013,8 @@ class DecidePlacement::TryPlacedPool {
         return NULL;
     }
     void *workerWait();
+    void push(std::function<void(int)> eval);
+    void waitAll();
 
  public:
     explicit TryPlacedPool(DecidePlacement &self, int n) : self(self) {
@@ -3921,6 +4050,8 @@ class DecidePlacement::TryPlacedPool {
     void addReq(const IR::MAU::Table *t, const Placed *done, const StageUseEstimate &current,
                 const TablePlacement::GatewayMergeChoices &gmc, const GroupPlace *group);
     bool fillTrial(safe_vector<const Placed *> &trial, bitvec &trial_tables);
+    void addBackfillReq(const Placed *done, const IR::MAU::Table *tbl, cstring before);
+    std::pair<const IR::MAU::Table *, const Placed *> firstBackfill();
 };
 
 // Worker thread that process request until the "terminated" flag is set
@@ -3930,54 +4061,60 @@ void *DecidePlacement::TryPlacedPool::workerWait() {
     GC_register_my_thread(&sb);
 
     while (!terminated.load()) {
-        std::pair<int, struct request_arg *> req;
+        std::pair<int, std::function<void(int)>> req;
         {
             std::unique_lock<std::mutex> guard(queue_mutex);
             queue_CV.wait(guard, [&] { return !work_queue.empty() || terminated.load(); });
             if (terminated.load()) {
                 break;
             }
-            req = work_queue.front();
+            req = std::move(work_queue.front());
             work_queue.pop();
         }
-        safe_vector<TablePlacement::Placed *> res = self.self.try_place_table(
-            req.second->t, req.second->done, req.second->current, *req.second->gmc);
-        {
-            std::lock_guard<std::mutex> guard(res_mutex);
-            work_result[req.first] = std::make_pair(std::move(res), req.second->group);
-            exe_req++;
-            res_CV.notify_one();
-        }
+        req.second(req.first);
     }
     GC_unregister_my_thread();
     return NULL;
 }
 
+void DecidePlacement::TryPlacedPool::push(std::function<void(int)> eval) {
+    std::lock_guard<std::mutex> guard(queue_mutex);
+    work_queue.push(std::make_pair(num_req++, std::move(eval)));
+    queue_CV.notify_one();
+}
+
+// Wait for the worker threads to finalize all the requested evaluations
+void DecidePlacement::TryPlacedPool::waitAll() {
+    int expected_req;
+    {
+        std::lock_guard<std::mutex> guard(queue_mutex);
+        expected_req = num_req;
+    }
+    std::unique_lock<std::mutex> guard(res_mutex);
+    res_CV.wait(guard, [&] { return exe_req == expected_req; });
+}
+
 // Add a request to be processed by one of the Worker Thread
 void DecidePlacement::TryPlacedPool::addReq(const IR::MAU::Table *t, const Placed *done,
                                             const StageUseEstimate &current,
                                             const TablePlacement::GatewayMergeChoices &gmc,
                                             const GroupPlace *group) {
     TablePlacement::GatewayMergeChoices *gmc_copy = new TablePlacement::GatewayMergeChoices(gmc);
-    request_arg *req_arg = new request_arg(t, done, current, gmc_copy, group);
-    std::lock_guard<std::mutex> guard(queue_mutex);
-    work_queue.push(std::make_pair(num_req++, req_arg));
-    queue_CV.notify_one();
+    push([this, t, done, &current, gmc_copy, group](int id) {
+        safe_vector<TablePlacement::Placed *> res =
+            self.self.try_place_table(t, done, current, *gmc_copy);
+        std::lock_guard<std::mutex> guard(res_mutex);
+        work_result[id] = std::make_pair(std::move(res), group);
+        exe_req++;
+        res_CV.notify_one();
+    });
 }
 
 // Wait for the worker thread to finalize all the requested evaluation than fill the trial vector
 // for further analysis by heuristic based best choice
 bool DecidePlacement::TryPlacedPool::fillTrial(safe_vector<const Placed *> &trial,
                                                bitvec &trial_tables) {
-    int expected_req;
-    {
-        std::lock_guard<std::mutex> guard(queue_mutex);
-        expected_req = num_req;
-    }
-    {
-        std::unique_lock<std::mutex> guard(res_mutex);
-        res_CV.wait(guard, [&] { return exe_req == expected_req; });
-    }
+    waitAll();
     for (auto &res : work_result) {
         for (auto &pl : res.second.first) {
             if (trial_tables[self.self.uid(pl->table)]) continue;
@@ -3990,6 +4127,34 @@ bool DecidePlacement::TryPlacedPool::fillTrial(safe_vector<const Placed *> &tria
     return true;
 }
 
+// Add a backfill candidate to be evaluated by one of the Worker Thread.  Like try_place_table,
+// try_backfill_table only works on clones of the placed list, so candidates can be evaluated
+// at the same time.
+void DecidePlacement::TryPlacedPool::addBackfillReq(const Placed *done, const IR::MAU::Table *tbl,
+                                                    cstring before) {
+    push([this, done, tbl, before](int id) {
+        const Placed *res = self.try_backfill_table(done, tbl, before);
+        std::lock_guard<std::mutex> guard(res_mutex);
+        backfill_result[id] = std::make_pair(tbl, res);
+        exe_req++;
+        res_CV.notify_one();
+    });
+}
+
+// Wait for all the backfill candidates and return the first one that could be backfilled in
+// request order, which is the one the sequential evaluation would have chosen.
+std::pair<const IR::MAU::Table *, const DecidePlacement::Placed *>
+DecidePlacement::TryPlacedPool::firstBackfill() {
+    waitAll();
+    for (auto &res : backfill_result) {
+        auto [tbl, backfilled] = res.second;
+        if (!backfilled) continue;
+        BUG_CHECK(backfilled->is_placed(tbl), "backfill !is_placed abort");
+        return res.second;
+    }
+    return {nullptr, nullptr};
+}
+
 // Reset the executed count to zero for the next round of evaluation
 void DecidePlacement::TryPlacedPool::cleanup() {
     {
@@ -4000,6 +4165,7 @@ void DecidePlacement::TryPlacedPool::cleanup() {
     {
         std::lock_guard<std::mutex> guard(res_mutex);
         work_result.clear();
+        backfill_result.clear();
         exe_req = 0;
     }
 }
@@ -4343,7 +4509,7 @@ const DecidePlacement::Placed *DecidePlacement::default_table_placement(const IR
     Backfill backfill(*this);
     BacktrackManagement bt_mgmt(*this, work, partly_placed, placed, backfill);
 #ifdef MULTITHREAD
-    TryPlacedPool placed_pool(*this, jobs);
+    TryPlacedPool placed_pool(*this, self.options.table_placement_jobs);
 #endif
     while (true) {
         // Empty work means that all the tables are actually placed. Save it as a complete
@@ -4568,19 +4734,34 @@ const DecidePlacement::Placed *DecidePlacement::default_table_placement(const IR
 
         if (placed && best->stage > placed->stage &&
             !self.options.disable_table_placement_backfill) {
+            const IR::MAU::Table *backfilled_tbl = nullptr;
             const Placed *backfilled = nullptr;
             /* look for a table that could be backfilled */
+#ifdef MULTITHREAD
+            /* evaluate all the candidates in parallel, and keep the first one found in
+             * backfill order, as the sequential search below does */
+            placed_pool.cleanup();
+            for (auto &bf : backfill) {
+                if (placed->is_placed(bf.table)) continue;
+                if (partly_placed.count(bf.table)) continue;
+                placed_pool.addBackfillReq(placed, bf.table, bf.before);
+            }
+            std::tie(backfilled_tbl, backfilled) = placed_pool.firstBackfill();
+#else
             for (auto &bf : backfill) {
                 if (placed->is_placed(bf.table)) continue;
                 if (partly_placed.count(bf.table)) continue;
                 if ((backfilled = try_backfill_table(placed, bf.table, bf.before))) {
                     BUG_CHECK(backfilled->is_placed(bf.table), "backfill !is_placed abort");
+                    backfilled_tbl = bf.table;
                     /* Found one -- currently we don't priorities if mulitple tables could
                      * be backfilled; just backfill the first found */
                     break;
                 }
             }
+#endif
             if (backfilled) {
+                log_backfilled(backfilled, backfilled_tbl);
                 placed = backfilled;
                 /* backfilling a table -- abort the current placement and go back and do it
                  * again in case something changed.  It seems that nothing ever should change
@@ -27,6 +27,10 @@
 #define BACKENDS_TOFINO_BF_P4C_MAU_TABLE_PLACEMENT_H_
 
 #include <map>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
+#include <string>
 
 #include "backends/tofino/bf-p4c/backend.h"
 #include "backends/tofino/bf-p4c/mau/dynamic_dep_metrics.h"
@@ -165,7 +169,7 @@ class TablePlacement : public PassManager {
     bool alloc_done = false;
 
     profile_t init_apply(const IR::Node *root) override;
-    void end_apply() override { placement_round++; };
+    void end_apply() override;
 
     bool try_pick_layout(const gress_t &gress, std::vector<Placed *> tables_to_allocate,
                          std::vector<Placed *> tables_placed);
@@ -174,6 +178,24 @@ class TablePlacement : public PassManager {
     bool try_alloc_imem(const gress_t &gress, std::vector<Placed *> tables_to_allocate,
                         std::vector<Placed *> tables_placed);
 
+    // Results of try_alloc_mem and failures of try_alloc_ixbar for stage contents that were
+    // already tried in this round, keyed by resource_key.  Placement tries the same stage
+    // contents many times (placing a table after other choices, backtracking, backfilling).
+    // Cleared at each round, as allocations depend on PHV allocation.
+    struct MemAllocResult {
+        bool fits;
+        std::vector<std::map<UniqueId, Memories::Use>> memuse;  // in resource_key order
+        cstring failure;
+    };
+    std::map<std::string, MemAllocResult> mem_alloc_cache;
+    std::map<std::string, cstring> ixbar_failure_cache;
+    int mem_alloc_cache_hits = 0, mem_alloc_cache_misses = 0;
+    int ixbar_failure_cache_hits = 0, ixbar_failure_cache_misses = 0;
+#ifdef MULTITHREAD
+    std::mutex resource_cache_mutex;
+#endif
+    std::string resource_key(const std::vector<Placed *> &tables) const;
+
     bool try_alloc_ixbar(Placed *next, std::vector<Placed *> allocated_layout);
     bool try_alloc_format(Placed *next, bool gw_linked);
     bool try_alloc_mem(Placed *next, std::vector<Placed *> whole_stage);
@@ -232,10 +254,6 @@ class DecidePlacement : public MauInspector {
     explicit DecidePlacement(TablePlacement &s);
 
  private:
-#ifdef MULTITHREAD
-    // Arbitrary number of worker threads that should be exposed as compiler option, e.g. "-j4"
-    int jobs = 4;
-#endif
     struct save_placement_t;
     std::map<cstring, save_placement_t> saved_placements;
     int backtrack_count = 0;  // number of times backtracked in this pipe
@@ -258,7 +276,9 @@ class DecidePlacement : public MauInspector {
     /// satisfied, i.e. all the tables that must be placed before table @p t (due to ordering
     /// imposed by the live range shrinking pass) have been placed. @returns false otherwise.
     bool are_metadata_deps_satisfied(const Placed *placed, const IR::MAU::Table *t) const;
-    Placed *try_backfill_table(const Placed *done, const IR::MAU::Table *tbl, cstring before);
+    Placed *try_backfill_table(const Placed *done, const IR::MAU::Table *tbl,
+                               cstring before) const;
+    void log_backfilled(const Placed *backfilled, const IR::MAU::Table *tbl) const;
     bool can_place_with_partly_placed(const IR::MAU::Table *tbl,
                                       const ordered_set<const IR::MAU::Table *> &partly_placed,
                                       const Placed *placed);
@@ -149,39 +149,45 @@ std::string PHV::Allocation::printARAedges() const {
     return ss.str();
 }
 
-void PHV::Allocation::addSlice(PHV::Container c, PHV::AllocSlice slice) {
-    // Get the current status in container_status_i, or its ancestors, if any.
+PHV::Allocation::ContainerStatus &PHV::Allocation::writableStatus(PHV::Container c) {
+    auto it = container_status_i.find(c);
+    if (it != container_status_i.end()) return it->second;
+    // Get the current status in its ancestors, if any.
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
+    auto &rv = container_status_i[c];
+    rv = std::move(status);
+    return rv;
+}
+
+void PHV::Allocation::addSlice(PHV::Container c, PHV::AllocSlice slice) {
+    auto &status = writableStatus(c);
     status.slices.insert(slice);
-    container_status_i[c] = status;
 
     // Update field status.
     field_status_i[slice.field()].insert(slice);
 
     // Update the allocation status of the container.
-    if (container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
-        PHV::Allocation::ContainerAllocStatus old_status = container_status_i[c].alloc_status;
+    if (status.alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
+        PHV::Allocation::ContainerAllocStatus old_status = status.alloc_status;
         bitvec allocated_bits;
-        for (const auto &slice : container_status_i[c].slices)
+        for (const auto &slice : status.slices)
             allocated_bits |= bitvec(slice.container_slice().lo, slice.width());
         if (allocated_bits == bitvec())
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
+            status.alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
         else if (allocated_bits == bitvec(0, c.size()))
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
+            status.alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
         else
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
+            status.alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
 
-        BUG_CHECK(
-            container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
-                (container_status_i[c].alloc_status ==
-                     PHV::Allocation::ContainerAllocStatus::EMPTY &&
-                 container_status_i[c].alloc_status == old_status),
-            "Changing allocation status from FULL or PARTIAL to EMPTY");
+        BUG_CHECK(status.alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
+                      (status.alloc_status == PHV::Allocation::ContainerAllocStatus::EMPTY &&
+                       status.alloc_status == old_status),
+                  "Changing allocation status from FULL or PARTIAL to EMPTY");
 
-        if (old_status != container_status_i[c].alloc_status) {
+        if (old_status != status.alloc_status) {
             --count_by_status_i[c.type().size()][old_status];
-            ++count_by_status_i[c.type().size()][container_status_i[c].alloc_status];
+            ++count_by_status_i[c.type().size()][status.alloc_status];
         }
     }
 }
@@ -256,35 +262,19 @@ bool PHV::Allocation::addDarkAllocation(const PHV::AllocSlice &slice) {
 }
 
 void PHV::Allocation::setGress(PHV::Container c, GressAssignment gress) {
-    // Get the current status in container_status_i, or its ancestors, if any.
-    const auto *container_status = this->getStatus(c);
-    ContainerStatus status = container_status ? *container_status : ContainerStatus();
-    status.gress = gress;
-    container_status_i[c] = status;
+    writableStatus(c).gress = gress;
 }
 
 void PHV::Allocation::setParserGroupGress(PHV::Container c, GressAssignment parserGroupGress) {
-    // Get the current status in container_status_i, or its ancestors, if any.
-    const auto *container_status = this->getStatus(c);
-    ContainerStatus status = container_status ? *container_status : ContainerStatus();
-    status.parserGroupGress = parserGroupGress;
-    container_status_i[c] = status;
+    writableStatus(c).parserGroupGress = parserGroupGress;
 }
 
 void PHV::Allocation::setDeparserGroupGress(PHV::Container c, GressAssignment deparserGroupGress) {
-    // Get the current status in container_status_i, or its ancestors, if any.
-    const auto *container_status = this->getStatus(c);
-    ContainerStatus status = container_status ? *container_status : ContainerStatus();
-    status.deparserGroupGress = deparserGroupGress;
-    container_status_i[c] = status;
+    writableStatus(c).deparserGroupGress = deparserGroupGress;
 }
 
 void PHV::Allocation::setParserExtractGroupSource(PHV::Container c, ExtractSource source) {
-    // Get the current status in container_status_i, or its ancestors, if any.
-    const auto *container_status = this->getStatus(c);
-    ContainerStatus status = container_status ? *container_status : ContainerStatus();
-    status.parserExtractGroupSource = source;
-    container_status_i[c] = status;
+    writableStatus(c).parserExtractGroupSource = source;
 }
 
 PHV::Allocation::MutuallyLiveSlices PHV::Allocation::liverange_overlapped_slices(
@@ -999,19 +989,24 @@ const PHV::Allocation::ContainerStatus *PHV::Transaction::getStatus(const PHV::C
     auto it = container_status_i.find(c);
     if (it != container_status_i.end()) return &it->second;
 
+    auto cached = parent_status_cache_i.find(c);
+    if (cached != parent_status_cache_i.end()) return &cached->second;
+
     // Otherwise, retrieve and cache parent info.
     const auto *parentStatus = parent_i->getStatus(c);
-    if (parentStatus) container_status_i[c] = *parentStatus;
-    return parentStatus;
+    if (!parentStatus) return nullptr;
+    return &parent_status_cache_i.emplace(c, *parentStatus).first->second;
 }
 
 PHV::Allocation::FieldStatus PHV::Transaction::getStatus(const PHV::Field *f) const {
-    // DO NOT cache field_status_i like container_status_i because
-    // container_status_i are always modified-by-copy, while this
-    // field_status_i are not. This leads to a bug that when field_status_i
-    // is modified in a parent transaction, children transactions can
-    // only see part of the actual alloc slices of @p field.
-    // Also, the performance improvement of caching is open to doubt.
+    // DO NOT cache field_status_i like container_status_i. The status of a
+    // container is copied whole from the parent the first time a transaction
+    // writes it (copy-on-write, see writableStatus), and only that copy is then
+    // modified in place, so a cached parent status is the complete status of
+    // the container. The field_status_i of a transaction only holds the slices
+    // added in it, so when field_status_i is modified in a parent transaction,
+    // children transactions could only see part of the actual alloc slices of
+    // @p field. Also, the performance improvement of caching is open to doubt.
     PHV::Allocation::FieldStatus rst;
     this->foreach_slice(f, [&](const AllocSlice &slice) { rst.insert(slice); });
     return rst;
@@ -1019,12 +1014,7 @@ PHV::Allocation::FieldStatus PHV::Transaction::getStatus(const PHV::Field *f) co
 
 void PHV::Transaction::foreach_slice(const PHV::Field *f,
                                      std::function<void(const AllocSlice &)> cb) const {
-    // DO NOT cache field_status_i like container_status_i because
-    // container_status_i are always modified-by-copy, while this
-    // field_status_i are not. This leads to a bug that when field_status_i
-    // is modified in a parent transaction, children transactions can
-    // only see part of the actual alloc slices of @p field.
-    // Also, the performance improvement of caching is open to doubt.
+    // field_status_i is not cached like container_status_i, see getStatus above.
     assoc::hash_set<le_bitrange> range_seen;
     if (field_status_i.count(f)) {
         for (const auto &slice : field_status_i.at(f)) {
@@ -179,8 +179,9 @@ class Allocation {
     assoc::hash_map<PHV::Size, ordered_map<ContainerAllocStatus, int>> count_by_status_i;
 
     // For efficiency, these are NOT copied from parent to child.  Changes in
-    // the child are copied back to the parent on commit.  However, parent info
-    // is copied to the child when queried, as a caching optimization.
+    // the child are copied back to the parent on commit.  Container status of the
+    // parent is copied to the child when first written; see also
+    // Transaction::parent_status_cache_i for reads.
     mutable ordered_map<PHV::Container, ContainerStatus> container_status_i;
     mutable ordered_map<const PHV::Field *, FieldStatus> field_status_i;
     /// Structure that remembers the actions at which metadata fields need to be initialized for a
@@ -224,6 +225,10 @@ class Allocation {
     /// Add the actions in @p actions to the metadata initialization points for @p slice.
     virtual void addMetaInitPoints(const AllocSlice &slice, const ActionSet &actions);
 
+    /// @returns the status of @p c owned by this allocation, for updating it in place.  It is
+    /// initialized from the status of @p c in the ancestors the first time @p c is written.
+    ContainerStatus &writableStatus(PHV::Container c);
+
     /// Uniform convenience abstraction for adding one slice.  For internal use
     /// only.  @c must exist in this Allocation.
     virtual void addSlice(PHV::Container c, AllocSlice slice);
@@ -561,6 +566,11 @@ class ConcreteAllocation : public Allocation {
 class Transaction : public Allocation {
     const Allocation *parent_i;
 
+    /// Status of the containers read from the ancestors, cached so that later reads do not walk
+    /// up the chain of transactions again.  Unlike container_status_i, they are not part of the
+    /// outstanding writes, so they are not merged back into the parent on commit.
+    mutable assoc::hash_map<PHV::Container, ContainerStatus> parent_status_cache_i;
+
  public:
     /// Uniform abstraction for accessing a container state.
     /// @returns the ContainerStatus of this allocation, if present.  Failing
@@ -703,6 +713,7 @@ class Transaction : public Allocation {
     /// Clears any allocation added to this transaction.
     void clearTransactionStatus() {
         container_status_i.clear();
+        parent_status_cache_i.clear();
         meta_init_points_i.clear();
         init_writes_i.clear();
         field_status_i.clear();
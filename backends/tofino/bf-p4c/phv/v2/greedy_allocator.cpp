@@ -18,6 +18,9 @@
 
 #include "backends/tofino/bf-p4c/phv/v2/greedy_allocator.h"
 
+#include <algorithm>
+
+#include "backends/tofino/bf-p4c/bf-p4c-options.h"
 #include "backends/tofino/bf-p4c/parde/clot/clot.h"
 #include "backends/tofino/bf-p4c/phv/utils/utils.h"
 #include "backends/tofino/bf-p4c/phv/v2/allocator_base.h"
@@ -41,6 +44,17 @@ Logging::FileLog *greedy_allocator_file_log(int pipeId, const cstring &prefix, i
     return new Logging::FileLog(pipeId, filename, Logging::Mode::AUTO);
 }
 
+/// @returns true if @p a and @p b have equal clusters and slice lists in the same order.
+/// Unlike SuperCluster::operator==, the order matters, because clusters are allocated in it.
+bool same_sliced_cluster(const SuperCluster *a, const SuperCluster *b) {
+    if (a == b) return true;
+    return std::equal(a->clusters().begin(), a->clusters().end(), b->clusters().begin(),
+                      b->clusters().end(), [](const auto *x, const auto *y) { return *x == *y; }) &&
+           std::equal(a->slice_lists().begin(), a->slice_lists().end(),
+                      b->slice_lists().begin(), b->slice_lists().end(),
+                      [](const auto *x, const auto *y) { return *x == *y; });
+}
+
 // SuperClusterMetrics collects metrics for super clusters.
 class SuperClusterMetrics {
  private:
@@ -417,6 +431,19 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
     int best_slicing_idx = 0;
     AllocError *last_err = new AllocError(ErrorCode::NO_SLICING_FOUND);
     *last_err << "found unsatisfiable constraints.";
+    // Consecutive slicings of the DFS iterator usually differ only in their last sliced
+    // clusters. The allocation of a sliced cluster only depends on the clusters allocated
+    // before it in the same slicing, so the allocated prefix of the previous slicing is reused
+    // as long as its sliced clusters are the same, with their clusters and slice lists in the
+    // same order, as the order they are allocated in can change the allocation.
+    struct AllocatedPrefix {
+        const PHV::SuperCluster *sc;
+        Transaction tx;  // transaction of the slicing after allocating sc.
+        std::optional<TxContStatus> diff;
+    };
+    std::vector<AllocatedPrefix> prev_prefix;
+    const bool reuse_prefix = !BackendOptions().disable_phv_slicing_reuse;
+    int n_reused = 0;
     slicing_ctx->iterate([&](std::list<PHV::SuperCluster *> sliced) {
         n_tried++;
         if (LOGGING(3)) {
@@ -425,23 +452,43 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
         }
         auto sliced_tx = new ordered_map<const PHV::SuperCluster *, TxContStatus>();
         auto this_slicing_tx = alloc.makeTransaction();
+        std::vector<AllocatedPrefix> prefix;
         for (const auto *sc : sliced) {
+            const size_t i = prefix.size();
+            if (reuse_prefix && i < prev_prefix.size() &&
+                same_sliced_cluster(prev_prefix[i].sc, sc)) {
+                LOG3("reuse allocation of sliced cluster from the previous slicing: " << sc->uid);
+                n_reused++;
+                this_slicing_tx = prev_prefix[i].tx;
+                if (prev_prefix[i].diff) sliced_tx->emplace(sc, *prev_prefix[i].diff);
+                prefix.push_back(prev_prefix[i]);
+                continue;
+            }
+            // the prefix cannot be reused after the first difference.
+            prev_prefix.clear();
             if (kit_i.is_clot_allocated(kit_i.clot, *sc)) {
                 LOG3("skip clot allocated cluster: " << sc->uid);
+                prefix.push_back({sc, this_slicing_tx, std::nullopt});
                 continue;
             }
             if (sc->is_deparser_zero_candidate()) {
                 LOG3("Found another deparser-zero cluster: " << sc);
                 auto tx = alloc_deparser_zero_cluster(ctx, this_slicing_tx, sc, phv_i);
                 this_slicing_tx.commit(tx);
+                prefix.push_back({sc, this_slicing_tx, std::nullopt});
                 continue;
             }
             auto rst =
                 try_sliced_super_cluster(ctx, this_slicing_tx, sc, container_groups, alloc_metrics);
             if (rst.ok()) {
-                sliced_tx->emplace(sc, rst.tx->get_actual_diff());  // copy before commit.
+                auto diff = rst.tx->get_actual_diff();  // copy before commit.
+                sliced_tx->emplace(sc, diff);
                 this_slicing_tx.commit(*rst.tx);
+                prefix.push_back({sc, this_slicing_tx, diff});
             } else {
+                // failures are not reused, because the slice lists to invalidate are the ones
+                // of this slicing.
+                prev_prefix = std::move(prefix);
                 last_err = new AllocError(rst.err->code);
                 LOG3("Slicing-attempt-" << n_tried << ": failed, while allocating: " << sc);
                 *last_err << ". Failed when allocating this sliced " << sc;
@@ -458,6 +505,7 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
                 return n_tried < max_slicings;
             }
         }
+        prev_prefix = std::move(prefix);
         LOG3("Slicing-attempt-" << n_tried << ": succeeded.");
         auto *this_slicing_score = ctx.score()->make(this_slicing_tx);
         LOG3("Slicing-attempt-" << n_tried << " score: " << this_slicing_score->str());
@@ -479,6 +527,9 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
         return n_tried < max_slicings;
     });
 
+    LOG3("Reused the allocation of " << n_reused << " sliced clusters in " << n_tried
+                                      << " slicing attempts.");
+
     /// allocation failed
     if (!best_score) {
         return AllocResultWithSlicingDetails(last_err);
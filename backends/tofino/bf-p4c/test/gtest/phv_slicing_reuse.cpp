@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+
+#include "bf_gtest_helpers.h"
+#include "gtest/gtest.h"
+
+namespace P4::Test {
+
+namespace PhvSlicingReuseTest {
+
+inline auto defs = R"(
+    match_kind {exact}
+    header H { bit<4> f1; bit<12> f2; bit<8> f3; bit<24> f4; bit<16> f5; bit<32> f6;}
+    struct headers_t { H h; }
+    struct local_metadata_t { bit<12> m1; bit<20> m2; bit<8> m3; } )";
+
+// The fields of different sizes written by the actions can be sliced in many ways, so several
+// slicings of their super clusters are tried.
+inline auto input = R"(
+        action set_a(bit<12> v) { meta.m1 = v; hdr.h.f1 = 1; hdr.h.f3 = hdr.h.f3 + 1; }
+        action set_b(bit<20> v) { meta.m2 = v; hdr.h.f4 = hdr.h.f4 + 2; }
+        action set_c() { meta.m3 = hdr.h.f3; hdr.h.f6 = hdr.h.f6 + 3; }
+        table test_a {
+            key = { hdr.h.f2 : exact; hdr.h.f5 : exact; }
+            actions = { set_a; set_b; }
+        }
+        table test_b {
+            key = { meta.m1 : exact; meta.m2 : exact; }
+            actions = { set_c; }
+        }
+        apply {
+            test_a.apply();
+            test_b.apply();
+            if (meta.m3 == 1) hdr.h.f5 = hdr.h.f5 + 1;
+        }
+    )";
+
+/// @returns the PHV assembly produced with or without reusing the allocated slicing prefixes.
+std::string phv_alloc(bool reuse) {
+    auto blk = reuse ? TestCode(TestCode::Hdr::TofinoMin, TestCode::tofino_shell(),
+                                {defs, TestCode::empty_state(), input, TestCode::empty_appy()},
+                                TestCode::tofino_shell_control_marker(),
+                                {"--no-dead-code-elimination", "--alt-phv-alloc"})
+                     : TestCode(TestCode::Hdr::TofinoMin, TestCode::tofino_shell(),
+                                {defs, TestCode::empty_state(), input, TestCode::empty_appy()},
+                                TestCode::tofino_shell_control_marker(),
+                                {"--no-dead-code-elimination", "--alt-phv-alloc",
+                                 "--disable-phv-slicing-reuse"});
+    EXPECT_TRUE(blk.CreateBackend());
+    EXPECT_TRUE(blk.apply_pass(TestCode::Pass::FullBackend));
+    return blk.extract_code(TestCode::CodeBlock::PhvAsm);
+}
+
+}  // namespace PhvSlicingReuseTest
+
+// Reusing the allocation of the prefix shared with the previous slicing must not change the
+// PHV allocation.
+TEST(PhvSlicingReuse, SameAllocationWithoutReuse) {
+    auto reused = PhvSlicingReuseTest::phv_alloc(true);
+    auto not_reused = PhvSlicingReuseTest::phv_alloc(false);
+    EXPECT_FALSE(reused.empty());
+    EXPECT_EQ(reused, not_reused);
+}
+
+}  // namespace P4::Test
@@ -1974,6 +1974,17 @@ TEST_F(TableDependencyGraphTest, LogicalVsPhysicalTest) {
             EXPECT_TRUE(hlam[(*it).first].count(d));
         }
     }
+    // The pairwise queries use the dense rows, which must agree with the maps
+    for (auto *t1 : {a, b, c, d, e, f, g, h}) {
+        for (auto *t2 : {a, b, c, d, e, f, g, h}) {
+            EXPECT_EQ(dg.happens_phys_after(t1, t2), hpam[t1].count(t2) > 0);
+            EXPECT_EQ(dg.happens_logi_after(t1, t2), hlam[t1].count(t2) > 0);
+            EXPECT_EQ(dg.happens_phys_before(t1, t2),
+                      dg.happens_phys_before_map[t1].count(t2) > 0);
+            EXPECT_EQ(dg.happens_logi_before(t1, t2),
+                      dg.happens_logi_before_map[t1].count(t2) > 0);
+        }
+    }
 
     Match::CheckList expected = {
         "#pipeline pipe\n",
@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bf_gtest_helpers.h"
+#include "gtest/gtest.h"
+#include "lib/log.h"
+
+namespace P4::Test {
+
+namespace TablePlacementCacheTest {
+
+inline auto defs = R"(
+    match_kind {exact}
+    header H { bit<16> f1; bit<16> f2; bit<16> f3;}
+    struct headers_t { H h; }
+    struct local_metadata_t {} )";
+
+/// Redirects std::clog, where the placement statistics are logged, temporarily.
+struct RedirectClog {
+    std::stringstream stream;
+    std::streambuf *old;
+    RedirectClog() : old(std::clog.rdbuf(stream.rdbuf())) {}
+    ~RedirectClog() { std::clog.rdbuf(old); }
+};
+
+}  // namespace TablePlacementCacheTest
+
+/// Restores the debug specs enabled by the -T option of a test, so that they do not leak into
+/// other tests.
+class TablePlacementCache : public ::testing::Test {
+    std::vector<std::string> specs;
+
+ protected:
+    void SetUp() override { specs = Log::getDebugSpecs(); }
+    void TearDown() override { Log::setDebugSpecs(specs); }
+};
+
+// test_b matches on the field written by test_a, so it can only go in stage 1.  It is tried
+// there alone when test_c is placed in stage 0, and again when it is placed itself, so the
+// second memory allocation of that stage comes from the cache.
+TEST_F(TablePlacementCache, SameStageContentsHitTheCache) {
+    auto input = R"(
+            action set_f2() { hdr.h.f2 = 1; }
+            action nop() {}
+            table test_a {
+                key = { hdr.h.f1 : exact; }
+                actions = { set_f2; }
+            }
+            table test_b {
+                key = { hdr.h.f2 : exact; }
+                actions = { nop; }
+            }
+            table test_c {
+                key = { hdr.h.f3 : exact; }
+                actions = { nop; }
+            }
+            apply {
+                test_a.apply();
+                test_b.apply();
+                test_c.apply();
+            }
+        )";
+
+    auto blk = TestCode(TestCode::Hdr::TofinoMin, TestCode::tofino_shell(),
+                        {TablePlacementCacheTest::defs, TestCode::empty_state(), input,
+                         TestCode::empty_appy()},
+                        TestCode::tofino_shell_control_marker(),
+                        {"--no-dead-code-elimination", "-T", "table_placement:1"});
+    EXPECT_TRUE(blk.CreateBackend());
+    std::string log;
+    {
+        TablePlacementCacheTest::RedirectClog clog;
+        EXPECT_TRUE(blk.apply_pass(TestCode::Pass::FullBackend));
+        log = clog.stream.str();
+    }
+
+    std::regex stats("memory allocation cache: (\\d+) hits");
+    int rounds = 0, hits = 0;
+    for (std::sregex_iterator it(log.begin(), log.end(), stats), end; it != end; ++it) {
+        rounds++;
+        hits += std::stoi((*it)[1]);
+    }
+    EXPECT_GT(rounds, 0) << log;
+    EXPECT_GT(hits, 0) << log;
+}
+
+}  // namespace P4::Test
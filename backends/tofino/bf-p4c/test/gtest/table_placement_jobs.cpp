@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifdef MULTITHREAD
+
+#include <string>
+
+#include "bf_gtest_helpers.h"
+#include "gtest/gtest.h"
+
+namespace P4::Test {
+
+namespace TablePlacementJobsTest {
+
+inline auto defs = R"(
+    match_kind {exact}
+    header H { bit<16> f1; bit<16> f2; bit<16> f3; bit<16> f4; bit<16> f5;}
+    struct headers_t { H h; }
+    struct local_metadata_t {} )";
+
+// test_b and test_d depend on the tables before them, so the independent tables test_c and
+// test_e are candidates to be backfilled in the stages left behind.
+inline auto input = R"(
+        action set_f2() { hdr.h.f2 = 1; }
+        action set_f4() { hdr.h.f4 = 1; }
+        action nop() {}
+        table test_a {
+            key = { hdr.h.f1 : exact; }
+            actions = { set_f2; }
+            size = 65536;
+        }
+        table test_b {
+            key = { hdr.h.f2 : exact; }
+            actions = { set_f4; }
+            size = 65536;
+        }
+        table test_c {
+            key = { hdr.h.f3 : exact; }
+            actions = { nop; }
+        }
+        table test_d {
+            key = { hdr.h.f4 : exact; }
+            actions = { nop; }
+        }
+        table test_e {
+            key = { hdr.h.f5 : exact; }
+            actions = { nop; }
+        }
+        apply {
+            test_a.apply();
+            test_b.apply();
+            test_c.apply();
+            test_d.apply();
+            test_e.apply();
+        }
+    )";
+
+/// @returns the MAU assembly produced with @p jobs table placement worker threads.
+std::string placement_with_jobs(const char *jobs) {
+    auto blk = TestCode(TestCode::Hdr::TofinoMin, TestCode::tofino_shell(),
+                        {defs, TestCode::empty_state(), input, TestCode::empty_appy()},
+                        TestCode::tofino_shell_control_marker(),
+                        {"--no-dead-code-elimination", "--table-placement-jobs", jobs});
+    EXPECT_TRUE(blk.CreateBackend());
+    EXPECT_TRUE(blk.apply_pass(TestCode::Pass::FullBackend));
+    return blk.extract_code(TestCode::CodeBlock::MauAsm);
+}
+
+}  // namespace TablePlacementJobsTest
+
+// The placement candidates, including the backfill candidates, are evaluated in parallel but
+// selected in the order of the serial search, so the result must not depend on the jobs.
+TEST(TablePlacementJobs, ParallelMatchesSerial) {
+    auto serial = TablePlacementJobsTest::placement_with_jobs("1");
+    auto parallel = TablePlacementJobsTest::placement_with_jobs("4");
+    EXPECT_FALSE(serial.empty());
+    EXPECT_EQ(serial, parallel);
+}
+
+}  // namespace P4::Test
+
+#endif  // MULTITHREAD
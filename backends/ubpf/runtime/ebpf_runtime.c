@@ -25,9 +25,12 @@ void usage(char *name) {
             "in the order given by the packet time,"
             "then feeds the individual packets into a filter function, "
             "and returns the output.\n");
-    fprintf(stderr, "Usage: %s [-d] -f file.pcap -n num_pcaps\n", name);
+    fprintf(stderr, "Usage: %s [-d] [-b iterations] -f file.pcap -n num_pcaps\n", name);
     fprintf(stderr, "Options:\n");
     fprintf(stderr, "\t-d: Turn on debug messages\n");
+    fprintf(stderr, "\t-b: Benchmark mode, run the packets through the filter "
+            "the given number of times and report the throughput instead of "
+            "writing output files\n");
     fprintf(stderr, "\t-f: The input pcap file\n");
     fprintf(stderr, "\t-n: Specifies the number of input pcap files\n");
     exit(EXIT_FAILURE);
@@ -48,9 +51,9 @@ static pcap_list_t *get_packets(const char *pcap_base, uint16_t num_pcaps, pcap_
     return merge_and_delete_lists(tmp_list_array, merged_list);
 }
 
-void launch_runtime(const char *pcap_name, uint16_t num_pcaps) {
+int launch_runtime(const char *pcap_name, uint16_t num_pcaps, uint64_t iterations) {
     if (num_pcaps == 0)
-        return;
+        return EXIT_SUCCESS;
     /* Initialize the list of input packets */
     pcap_list_t *input_list = allocate_pkt_list();
 
@@ -69,23 +72,38 @@ void launch_runtime(const char *pcap_name, uint16_t num_pcaps) {
     input_list = get_packets(pcap_base, num_pcaps, input_list);
     /* Sort the list */
     sort_pcap_list(input_list);
-    /* Run the "program" and retrieve output lists */
-    RUN(entry, pcap_base, num_pcaps, input_list, debug);
+    int result = EXIT_SUCCESS;
+    if (iterations > 0) {
+        /* Measure the "program" without recording any output */
+        result = BENCHMARK(entry, input_list, iterations, debug);
+    } else {
+        /* Run the "program" and retrieve output lists */
+        RUN(entry, pcap_base, num_pcaps, input_list, debug);
+    }
     /* Delete the list of input packets */
     delete_list(input_list);
+    return result;
 }
 
 int main(int argc, char **argv) {
     const char *pcap_name = NULL;
     int num_pcaps = -1;
+    uint64_t iterations = 0;
     int c;
     opterr = 0;
 
-    while ((c = getopt (argc, argv, "dn:f:")) != -1) {
+    while ((c = getopt (argc, argv, "db:n:f:")) != -1) {
         switch (c) {
             case 'd':
             debug = 1;
             break;
+            case 'b':
+                iterations = strtoull(optarg, (char **)NULL, 10);
+                if (iterations == 0) {
+                    fprintf(stderr, "Number of benchmark iterations must be positive\n");
+                    return EXIT_FAILURE;
+                }
+            break;
             case 'n':
                 num_pcaps = (int)strtol(optarg, (char **)NULL, 10);
                 if (num_pcaps < 0 || num_pcaps > UINT16_MAX) {
@@ -124,7 +142,5 @@ int main(int argc, char **argv) {
     setup_control_plane();
 #endif
 
-    launch_runtime(pcap_name, num_pcaps);
-
-    return EXIT_SUCCESS;
+    return launch_runtime(pcap_name, num_pcaps, iterations);
 }
@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
 #include "ebpf_runtime_ubpf.h"
 
 
@@ -71,4 +72,80 @@ void *run_and_record_output(packet_filter entry, const char *pcap_base, pcap_lis
     write_pkts_to_pcaps(pcap_base, output_array, debug);
     /* Delete the array, including the data it is holding */
     delete_array(output_array);
-}
\ No newline at end of file
+}
+
+static uint64_t get_time_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int run_benchmark(packet_filter entry, pcap_list_t *pkt_list, uint64_t iterations, int debug) {
+    /* Preload all packets into one contiguous buffer to keep allocation and
+     * list traversal out of the measured loop */
+    pcap_buffer_t *buf = flatten_pkt_list(pkt_list);
+    if (buf->num_pkts == 0) {
+        fprintf(stderr, "No input packets, nothing to benchmark.\n");
+        delete_pkt_buffer(buf);
+        return EXIT_FAILURE;
+    }
+    /* The program may rewrite or resize the packet, so each run works on a
+     * heap-allocated scratch copy which ubpf_adjust_head() can reallocate */
+    size_t scratch_len = buf->max_len ? buf->max_len : 1;
+    void *scratch = malloc(scratch_len);
+    if (scratch == NULL) {
+        perror("Fatal: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    struct std_meta {
+        uint32_t input_port;
+        uint32_t packet_length;
+        uint32_t output_action;
+        uint32_t output_port;
+    };
+    uint64_t passed = 0;
+    registry_reset_lookup_stats();
+    uint64_t start = get_time_ns();
+    for (uint64_t it = 0; it < iterations; it++) {
+        for (uint32_t i = 0; i < buf->num_pkts; i++) {
+            struct dp_packet dp;
+            struct std_meta md;
+            memcpy(scratch, buf->data + buf->offsets[i], buf->lengths[i]);
+            dp.data = scratch;
+            dp.size_ = buf->lengths[i];
+
+            md.input_port = buf->ifindex[i];
+            md.packet_length = dp.size_;
+            md.output_port = 0;
+
+            if (entry(&dp, (struct standard_metadata *) &md) != 0)
+                passed++;
+            /* ubpf_adjust_head() reallocates the packet whenever it resizes it,
+             * restore the scratch capacity then, outside of the measured time */
+            if (dp.data != scratch || dp.size_ != buf->lengths[i]) {
+                uint64_t pause = get_time_ns();
+                scratch = realloc(dp.data, scratch_len);
+                if (scratch == NULL) {
+                    perror("Fatal: Could not allocate memory\n");
+                    exit(EXIT_FAILURE);
+                }
+                start += get_time_ns() - pause;
+            }
+        }
+    }
+    uint64_t elapsed = get_time_ns() - start;
+    uint64_t total = iterations * buf->num_pkts;
+    printf("Benchmark: %u packets x %llu iterations\n", buf->num_pkts,
+           (unsigned long long) iterations);
+    printf("  total: %llu packets (%llu passed) in %.3f ms\n", (unsigned long long) total,
+           (unsigned long long) passed, elapsed / 1e6);
+    if (elapsed != 0)
+        printf("  throughput: %.0f packets/sec\n", total * 1e9 / elapsed);
+    printf("  latency: %.1f ns/packet\n", (double) elapsed / total);
+    registry_print_lookup_stats(stdout, total);
+    if (debug)
+        printf("Largest packet in the benchmark: %u bytes\n", buf->max_len);
+    free(scratch);
+    delete_pkt_buffer(buf);
+    return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@ extern uint64_t entry(void *, struct standard_metadata *);
 typedef uint64_t (*packet_filter)(void *dp, struct standard_metadata *std_meta);
 
 void *run_and_record_output(packet_filter entry, const char *pcap_base, pcap_list_t *pkt_list, int debug);
+int run_benchmark(packet_filter entry, pcap_list_t *pkt_list, uint64_t iterations, int debug);
 
 static void inline init_ubpf_table_test(char *name, unsigned int key_size, unsigned int value_size) {
     struct bpf_table tbl = {
@@ -49,6 +50,8 @@ static void inline init_ubpf_table_test(char *name, unsigned int key_size, unsig
 
 #define RUN(entry, pcap_base, num_pcaps, input_list, debug) \
     run_and_record_output(entry, pcap_base, input_list, debug)
+#define BENCHMARK(entry, input_list, iterations, debug) \
+    run_benchmark(entry, input_list, iterations, debug)
 #define INIT_EBPF_TABLES(debug)
 #define DELETE_EBPF_TABLES(debug)
 
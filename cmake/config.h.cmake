@@ -47,4 +47,10 @@
 /* The maximum logging level for -T logs */
 #cmakedefine MAX_LOGGING_LEVEL @MAX_LOGGING_LEVEL@
 
+/* The maximum logging levels for -T logs of parts of the compiler, if lower */
+@P4C_SUBSYSTEM_MAX_LOGGING_LEVELS@
+/* The source and build directories, the part of the compiler of a file is found relative to them */
+#define P4C_SOURCE_DIR "@P4C_SOURCE_DIR@/"
+#define P4C_BINARY_DIR "@P4C_BINARY_DIR@/"
+
 #cmakedefine P4C_GTEST_ENABLED 1
\ No newline at end of file
@@ -7,6 +7,7 @@
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 #pragma GCC diagnostic pop
@@ -127,21 +128,21 @@ static bool writeJsonTo(const Message &message, std::ostream *destination,
 static bool writeTextTo(const Message &message, std::ostream *destination) {
     CHECK_NULL(destination);
 
-    // According to the protobuf documentation, it would be better to use Print
-    // with a FileOutputStream object for performance reasons. However all we
-    // have here is a std::ostream and performance is not a concern.
-    std::string output;
     google::protobuf::TextFormat::Printer textPrinter;
     // set to expand google.protobuf.Any payloads
     textPrinter.SetExpandAny(true);
     *destination << "# proto-file: " << message.GetDescriptor()->file()->name() << "\n";
     *destination << "# proto-message: " << message.GetTypeName() << "\n\n";
-    if (!textPrinter.PrintToString(message, &output)) {
-        ::P4::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
-        return false;
+    {
+        // Print straight to the output rather than to a string first: the entries of large
+        // tables make strings of hundreds of megabytes.
+        google::protobuf::io::OstreamOutputStream output(destination);
+        if (!textPrinter.Print(message, &output)) {
+            ::P4::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
+            return false;
+        }
     }
 
-    *destination << output;
     if (!destination->good()) {
         ::P4::error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
         return false;
@@ -1069,6 +1070,7 @@ class P4RuntimeEntriesConverter {
 
         int entryPriority = entriesList->entries.size();
         auto needsPriority = tableNeedsPriority(table, refMap);
+        entries->mutable_updates()->Reserve(entries->updates_size() + entriesList->entries.size());
         for (auto e : entriesList->entries) {
             auto protoUpdate = entries->add_updates();
             protoUpdate->set_type(p4v1::Update::INSERT);
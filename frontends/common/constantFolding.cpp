@@ -673,9 +673,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Slice *e) {
     }
     if (overflowWidth(e, m) || overflowWidth(e, l)) return e;
     big_int value = cbase->value >> l;
-    big_int mask = 1;
-    mask = (mask << (m - l + 1)) - 1;
-    value = value & mask;
+    value = value & Util::mask(m - l + 1);
     auto resultType = IR::Type_Bits::get(m - l + 1);
     return new IR::Constant(e->srcInfo, resultType, value, cbase->base, true);
 }
@@ -155,6 +155,15 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
             return true;
         },
         "Unrolling all parser's loops");
+    registerOption(
+        "--merge-tables", nullptr,
+        [this](const char *) {
+            mergeTables = true;
+            return true;
+        },
+        "Merge tables with constant entries and a constant default action that are applied\n"
+        "one after the other into a single hidden table (the merged tables are not in the\n"
+        "control plane API, which may already have been generated with them).");
     registerOption(
         "-O", nullptr,
         [this](const char *level) {
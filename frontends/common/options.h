@@ -81,6 +81,8 @@ class CompilerOptions : public ParserOptions {
     cstring arch = nullptr;
     // If true, unroll all parser loops inside the midend.
     bool loopsUnrolling = false;
+    // If true, merge tables with fixed contents applied back-to-back (see MergeTables).
+    bool mergeTables = false;
     // List of code metrics input by user.
     cstring inputMetrics = nullptr;
     // Code metrics to be collected.
@@ -12,13 +12,16 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 
+#include <cstring>
 #include <filesystem>
 #include <memory>
 #include <regex>
+#include <sstream>
 #include <unordered_set>
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
+#include "frontends/common/preprocessor.h"
 #include "frontends/p4/toP4/toP4.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
@@ -198,6 +201,14 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
             return true;
         },
         "Skip preprocess, assume input file is already preprocessed.");
+    registerOption(
+        "--builtin-preprocessor", nullptr,
+        [this](const char *) {
+            builtinPreprocessor = true;
+            return true;
+        },
+        "Preprocess in-process instead of running cpp. Only -I, -D and -U are supported; "
+        "cpp is still used with other preprocessor options.");
     registerOption(
         "--disable-annotations", "annotations",
         [this](const char *arg) {
@@ -405,11 +416,69 @@ const char *ParserOptions::getIncludePath() const {
     return path.c_str();
 }
 
+/// Preprocesses @p file with the in-process Preprocessor, and the -I, -D and -U options
+/// in @p options. @p output is std::nullopt if the file cannot be read.
+/// @return false if @p options has other options, which cpp must handle.
+static bool builtinPreprocess(const std::filesystem::path &file, const std::string &options,
+                              std::optional<std::string> &output) {
+    std::vector<std::filesystem::path> includePaths;
+    std::vector<std::pair<char, std::string>> macros;
+    std::istringstream words(options);
+    std::string word;
+    while (words >> word) {
+        if (word.size() < 2 || word[0] != '-' || !strchr("IDU", word[1]) ||
+            word.find_first_of("\"'\\") != std::string::npos)
+            return false;
+        std::string arg = word.substr(2);
+        if (arg.empty() && !(words >> arg)) return false;
+        if (word[1] == 'I')
+            includePaths.emplace_back(arg);
+        else
+            macros.emplace_back(word[1], arg);
+    }
+
+    Preprocessor preprocessor(std::move(includePaths));
+    for (auto &[option, macro] : macros) {
+        if (option == 'D')
+            preprocessor.define(macro);
+        else
+            preprocessor.undefine(macro);
+    }
+    output = preprocessor.preprocess(file);
+    return true;
+}
+
 std::optional<ParserOptions::PreprocessorResult> ParserOptions::preprocess() const {
     FILE *in = nullptr;
 
+    std::optional<std::string> builtinOutput;
+    bool builtin = false;
+    if (builtinPreprocessor && file != "-") {
+        if (Log::verbose()) std::cerr << "Invoking builtin preprocessor" << std::endl;
+        builtin = builtinPreprocess(file, preprocessor_options.string() + getIncludePath(),
+                                    builtinOutput);
+        if (!builtin && Log::verbose())
+            std::cerr << "Unsupported preprocessor options, using cpp" << std::endl;
+    }
+
     if (file == "-") {
         in = stdin;
+    } else if (builtin) {
+        if (!builtinOutput) return std::nullopt;
+        if (doNotCompile) {
+            fwrite(builtinOutput->data(), 1, builtinOutput->size(), stdout);
+            return std::nullopt;
+        }
+        // The lexer reads the output from memory. fmemopen keeps a byte for a final null.
+        in = fmemopen(nullptr, builtinOutput->size() + 1, "w+");
+        if (in == nullptr ||
+            fwrite(builtinOutput->data(), 1, builtinOutput->size(), in) != builtinOutput->size()) {
+            ::P4::error(ErrorType::ERR_IO, "Error reading the preprocessor output");
+            if (in != nullptr) fclose(in);
+            return std::nullopt;
+        }
+        rewind(in);
+        return ParserOptions::PreprocessorResult(in, [](FILE *stream) { fclose(stream); });
     } else {
 #ifdef __clang__
         std::string cmd("cc -E -x c -Wno-comment");
@@ -78,6 +78,8 @@ class ParserOptions : public Util::Options {
     cstring compilerVersion;
     /// if true skip preprocess
     bool doNotPreprocess = false;
+    /// if true preprocess with the in-process Preprocessor instead of cpp
+    bool builtinPreprocessor = false;
     /// substrings matched against pass names
     std::vector<cstring> top4;
     /// debugging dumps of programs written in this folder
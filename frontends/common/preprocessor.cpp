@@ -0,0 +1,929 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "preprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+#include "lib/error.h"
+
+namespace P4 {
+
+namespace {
+
+/// The contents of a file, read in memory so that changes to the file while it is
+/// preprocessed cannot affect the text.
+struct SourceFile {
+    std::string text;
+    std::uintmax_t size = 0;
+    std::filesystem::file_time_type mtime;
+};
+
+/// Reads @p path, or returns the contents read by a previous call if the file has not changed
+/// since.  The files are cached by canonical path until the end of the process, so that the
+/// same file included through different paths is read once.
+std::shared_ptr<const SourceFile> readFile(const std::filesystem::path &path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const SourceFile>> cache;
+
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) return nullptr;
+    auto canonical = std::filesystem::canonical(path, ec);
+    if (ec) return nullptr;
+    auto size = std::filesystem::file_size(canonical, ec);
+    if (ec) return nullptr;
+    auto mtime = std::filesystem::last_write_time(canonical, ec);
+    if (ec) return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &cached = cache[canonical.string()];
+    if (cached && cached->size == size && cached->mtime == mtime) return cached;
+
+    std::ifstream in(canonical, std::ios::binary);
+    if (!in) return nullptr;
+    auto file = std::make_shared<SourceFile>();
+    file->text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) return nullptr;
+    file->size = size;
+    file->mtime = mtime;
+    cached = file;
+    return file;
+}
+
+bool isWordChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+bool isPunctChar(char c) { return std::strchr("+-*/%<>=!&|^.#:", c) != nullptr && c != '\0'; }
+
+/// True if the characters @p a and @p b would be read as a single token when written next
+/// to each other.
+bool wouldPaste(char a, char b) {
+    return (isWordChar(a) && isWordChar(b)) || (isPunctChar(a) && isPunctChar(b));
+}
+
+/// Writes @p text as a string literal, as the # operator and the line markers.
+std::string quote(std::string_view text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result + "\"";
+}
+
+/// Evaluates the integer expressions of #if, once macros and defined() are replaced.
+class ExpressionEvaluator {
+    const std::vector<std::string> &tokens;
+    size_t pos = 0;
+    /// Number of enclosing operands that are not evaluated, such as the right operand of
+    /// `0 && x`, where division by zero is not an error.
+    unsigned unevaluated = 0;
+
+    bool at(std::string_view token) const { return pos < tokens.size() && tokens[pos] == token; }
+    bool accept(std::string_view token) {
+        if (!at(token)) return false;
+        ++pos;
+        return true;
+    }
+    void expect(std::string_view token) {
+        if (!accept(token)) fail("expected '" + std::string(token) + "'");
+    }
+    [[noreturn]] void fail(const std::string &message) const {
+        if (pos < tokens.size())
+            throw std::runtime_error(message + " before '" + tokens[pos] + "'");
+        throw std::runtime_error(message + " at end of expression");
+    }
+
+    int64_t number(const std::string &text) const {
+        std::string digits = text;
+        while (!digits.empty() && std::strchr("uUlL", digits.back())) digits.pop_back();
+        int base = 10;
+        size_t start = 0;
+        if (digits.size() > 1 && digits[0] == '0') {
+            if (digits[1] == 'x' || digits[1] == 'X') {
+                base = 16;
+                start = 2;
+            } else if (digits[1] == 'b' || digits[1] == 'B') {
+                base = 2;
+                start = 2;
+            } else {
+                base = 8;
+            }
+        }
+        char *end = nullptr;
+        errno = 0;
+        uint64_t value = std::strtoull(digits.c_str() + start, &end, base);
+        if (start == digits.size() || *end != '\0' || errno != 0)
+            throw std::runtime_error("invalid integer constant '" + text + "'");
+        return static_cast<int64_t>(value);
+    }
+
+    int64_t primary() {
+        if (accept("(")) {
+            int64_t value = conditional();
+            expect(")");
+            return value;
+        }
+        if (pos < tokens.size() && std::isdigit(static_cast<unsigned char>(tokens[pos][0])))
+            return number(tokens[pos++]);
+        fail("expected value");
+    }
+
+    int64_t unary() {
+        if (accept("+")) return unary();
+        if (accept("-")) return static_cast<int64_t>(0 - static_cast<uint64_t>(unary()));
+        if (accept("~")) return ~unary();
+        if (accept("!")) return !unary();
+        return primary();
+    }
+
+    int64_t multiplicative() {
+        int64_t value = unary();
+        while (true) {
+            if (accept("*")) {
+                value = static_cast<int64_t>(static_cast<uint64_t>(value) *
+                                             static_cast<uint64_t>(unary()));
+            } else if (at("/") || at("%")) {
+                bool divide = tokens[pos++] == "/";
+                int64_t right = unary();
+                if (right == 0) {
+                    if (!unevaluated) throw std::runtime_error("division by zero");
+                    value = 0;
+                } else if (right == -1) {
+                    value = divide ? static_cast<int64_t>(0 - static_cast<uint64_t>(value)) : 0;
+                } else {
+                    value = divide ? value / right : value % right;
+                }
+            } else {
+                return value;
+            }
+        }
+    }
+
+    int64_t additive() {
+        int64_t value = multiplicative();
+        while (true) {
+            if (accept("+"))
+                value = static_cast<int64_t>(static_cast<uint64_t>(value) +
+                                             static_cast<uint64_t>(multiplicative()));
+            else if (accept("-"))
+                value = static_cast<int64_t>(static_cast<uint64_t>(value) -
+                                             static_cast<uint64_t>(multiplicative()));
+            else
+                return value;
+        }
+    }
+
+    int64_t shift() {
+        int64_t value = additive();
+        while (true) {
+            if (accept("<<")) {
+                int64_t right = additive();
+                value = right < 0 || right > 63
+                            ? 0
+                            : static_cast<int64_t>(static_cast<uint64_t>(value) << right);
+            } else if (accept(">>")) {
+                int64_t right = additive();
+                value = right < 0 || right > 63 ? (value < 0 ? -1 : 0) : value >> right;
+            } else {
+                return value;
+            }
+        }
+    }
+
+    int64_t relational() {
+        int64_t value = shift();
+        while (true) {
+            if (accept("<"))
+                value = value < shift();
+            else if (accept(">"))
+                value = value > shift();
+            else if (accept("<="))
+                value = value <= shift();
+            else if (accept(">="))
+                value = value >= shift();
+            else
+                return value;
+        }
+    }
+
+    int64_t equality() {
+        int64_t value = relational();
+        while (true) {
+            if (accept("=="))
+                value = value == relational();
+            else if (accept("!="))
+                value = value != relational();
+            else
+                return value;
+        }
+    }
+
+    int64_t bitAnd() {
+        int64_t value = equality();
+        while (accept("&")) value &= equality();
+        return value;
+    }
+
+    int64_t bitXor() {
+        int64_t value = bitAnd();
+        while (accept("^")) value ^= bitAnd();
+        return value;
+    }
+
+    int64_t bitOr() {
+        int64_t value = bitXor();
+        while (accept("|")) value |= bitXor();
+        return value;
+    }
+
+    /// Evaluates @p operand, which is not evaluated in C if @p evaluated is false.
+    template <typename F>
+    int64_t maybeEvaluated(bool evaluated, F operand) {
+        if (evaluated) return operand();
+        ++unevaluated;
+        int64_t value = operand();
+        --unevaluated;
+        return value;
+    }
+
+    int64_t logicalAnd() {
+        int64_t value = bitOr();
+        while (accept("&&")) {
+            bool right = maybeEvaluated(value, [this] { return bitOr(); });
+            value = value && right;
+        }
+        return value;
+    }
+
+    int64_t logicalOr() {
+        int64_t value = logicalAnd();
+        while (accept("||")) {
+            bool right = maybeEvaluated(!value, [this] { return logicalAnd(); });
+            value = value || right;
+        }
+        return value;
+    }
+
+    int64_t conditional() {
+        int64_t value = logicalOr();
+        if (!accept("?")) return value;
+        int64_t ifTrue = maybeEvaluated(value, [this] { return conditional(); });
+        expect(":");
+        int64_t ifFalse = maybeEvaluated(!value, [this] { return conditional(); });
+        return value ? ifTrue : ifFalse;
+    }
+
+ public:
+    explicit ExpressionEvaluator(const std::vector<std::string> &tokens) : tokens(tokens) {}
+
+    /// @return the value of the expression; throws std::runtime_error if it is invalid.
+    int64_t evaluate() {
+        if (tokens.empty()) throw std::runtime_error("#if with no expression");
+        int64_t value = conditional();
+        if (pos != tokens.size()) fail("missing binary operator");
+        return value;
+    }
+};
+
+}  // namespace
+
+std::vector<Preprocessor::Token> Preprocessor::tokenize(std::string_view text) {
+    static constexpr std::string_view punctuators[] = {
+        ">>=", "<<=", "...", "##", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=",
+        "&&",  "||",  "*=",  "/=", "%=", "+=", "-=", "&=", "^=", "|=", "::"};
+
+    std::vector<Token> tokens;
+    size_t pos = 0;
+    auto scan = [&](Token::Kind kind, size_t end) {
+        tokens.emplace_back(kind, std::string(text.substr(pos, end - pos)));
+        pos = end;
+    };
+    while (pos < text.size()) {
+        char c = text[pos];
+        size_t end = pos + 1;
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            while (end < text.size() && std::isspace(static_cast<unsigned char>(text[end])))
+                ++end;
+            scan(Token::Space, end);
+        } else if (text.substr(pos, 2) == "/*") {
+            end = text.find("*/", pos + 2);
+            scan(Token::Comment, end == std::string_view::npos ? text.size() : end + 2);
+        } else if (text.substr(pos, 2) == "//") {
+            scan(Token::Comment, text.size());
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            while (end < text.size() && isWordChar(text[end])) ++end;
+            scan(Token::Identifier, end);
+        } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '.' && end < text.size() &&
+                    std::isdigit(static_cast<unsigned char>(text[end])))) {
+            while (end < text.size()) {
+                if (std::strchr("eEpP", text[end]) && end + 1 < text.size() &&
+                    (text[end + 1] == '+' || text[end + 1] == '-'))
+                    end += 2;
+                else if (isWordChar(text[end]) || text[end] == '.')
+                    ++end;
+                else
+                    break;
+            }
+            scan(Token::Number, end);
+        } else if (c == '"') {
+            while (end < text.size() && text[end] != '"') end += text[end] == '\\' ? 2 : 1;
+            scan(Token::String, std::min(end + 1, text.size()));
+        } else {
+            for (auto punct : punctuators) {
+                if (text.substr(pos, punct.size()) == punct) {
+                    end = pos + punct.size();
+                    break;
+                }
+            }
+            scan(Token::Punct, end);
+        }
+    }
+    return tokens;
+}
+
+bool Preprocessor::nextLine(std::vector<Token> &tokens) {
+    auto &input = *inputs.back();
+    auto text = input.text;
+    if (input.pos >= text.size()) return false;
+
+    // Joins the lines ended by a backslash, and the lines of block comments.
+    std::string line;
+    enum { Code, String, BlockComment, LineComment } state = Code;
+    while (input.pos < text.size()) {
+        char c = text[input.pos];
+        char next = input.pos + 1 < text.size() ? text[input.pos + 1] : '\0';
+        bool crlf = next == '\r' && text.substr(input.pos + 2, 1) == "\n";
+        if (c == '\\' && (next == '\n' || crlf)) {
+            input.pos += crlf ? 3 : 2;
+            ++input.line;
+            continue;
+        }
+        ++input.pos;
+        if (c == '\n') {
+            ++input.line;
+            if (state != BlockComment) break;
+        } else if (state == Code) {
+            if (c == '"') {
+                state = String;
+            } else if (c == '/' && (next == '*' || next == '/')) {
+                state = next == '*' ? BlockComment : LineComment;
+                line += c;
+                c = next;
+                ++input.pos;
+            }
+        } else if (state == String) {
+            if (c == '\\' && next != '\0' && next != '\n') {
+                line += c;
+                c = next;
+                ++input.pos;
+            } else if (c == '"') {
+                state = Code;
+            }
+        } else if (state == BlockComment && c == '*' && next == '/') {
+            line += c;
+            c = next;
+            ++input.pos;
+            state = Code;
+        }
+        line += c;
+    }
+    tokens = tokenize(line);
+    return true;
+}
+
+bool Preprocessor::fetchArgumentLine(std::deque<Token> &pending) {
+    auto &input = *inputs.back();
+    auto rest = input.text.substr(std::min(input.pos, input.text.size()));
+    auto first = rest.find_first_not_of(" \t\r\f\v");
+    if (first == std::string_view::npos || rest[first] == '#') return false;
+    std::vector<Token> tokens;
+    if (!nextLine(tokens)) return false;
+    pending.emplace_back(Token::Space, " ");
+    pending.insert(pending.end(), tokens.begin(), tokens.end());
+    return true;
+}
+
+void Preprocessor::define(std::string_view definition) {
+    std::string text(definition);
+    auto equal = text.find('=');
+    if (equal == std::string::npos)
+        text += " 1";
+    else
+        text[equal] = ' ';
+    defineMacro(tokenize(text), 0);
+}
+
+std::optional<std::string> Preprocessor::preprocess(const std::filesystem::path &file) {
+    auto source = readFile(file);
+    if (!source) {
+        ::P4::error(ErrorType::ERR_IO, "%1%: cannot read file", file.string());
+        return std::nullopt;
+    }
+    output.clear();
+    processFile(file, source->text, 0);
+    return std::move(output);
+}
+
+std::string Preprocessor::preprocess(std::string_view name, std::string_view text) {
+    output.clear();
+    processFile(std::filesystem::path(name), text, 0);
+    return std::move(output);
+}
+
+void Preprocessor::processFile(const std::filesystem::path &path, std::string_view text,
+                               int flag) {
+    Input input;
+    input.path = path;
+    input.text = text;
+    inputs.push_back(&input);
+    writeLineMarker(1, path, flag);
+
+    std::vector<Token> tokens;
+    while (true) {
+        input.lineStart = input.line;
+        if (!nextLine(tokens)) break;
+        size_t start = output.size();
+        auto first = std::find_if(tokens.begin(), tokens.end(),
+                                  [](const Token &token) { return !token.isSpace(); });
+        if (first != tokens.end() && first->is("#")) {
+            if (directive(tokens)) continue;
+        } else if (input.active()) {
+            write(expand(std::move(tokens), true));
+        }
+
+        // Keeps the output in sync with the lines of the input.
+        auto written =
+            static_cast<unsigned>(std::count(output.begin() + start, output.end(), '\n'));
+        auto consumed = input.line - input.lineStart;
+        if (written <= consumed)
+            output.append(consumed - written, '\n');
+        else
+            writeLineMarker(input.line, path, 0);
+    }
+
+    if (!input.conditions.empty()) reportError(ErrorType::ERR_INVALID, "unterminated #if");
+    inputs.pop_back();
+}
+
+bool Preprocessor::directive(std::vector<Token> &tokens) {
+    auto &input = *inputs.back();
+    auto skipSpaces = [&](size_t index) {
+        while (index < tokens.size() && tokens[index].isSpace()) ++index;
+        return index;
+    };
+    size_t index = skipSpaces(skipSpaces(0) + 1);
+    if (index == tokens.size()) return false;
+    std::string name = tokens[index].kind == Token::Identifier ? tokens[index].text : "";
+    size_t args = skipSpaces(index + 1);
+    auto restOfLine = [&]() {
+        std::string text;
+        for (size_t i = args; i < tokens.size(); ++i) text += tokens[i].text;
+        return text;
+    };
+
+    if (name == "if" || name == "ifdef" || name == "ifndef") {
+        if (!input.active()) {
+            input.conditions.push_back({false, true});
+            return false;
+        }
+        bool value = false;
+        if (name == "if") {
+            value = evaluate(tokens, args);
+        } else if (args == tokens.size() || tokens[args].kind != Token::Identifier) {
+            reportError(ErrorType::ERR_INVALID, "no macro name given in #" + name + " directive");
+        } else {
+            value = macros.count(tokens[args].text) != 0;
+            if (name == "ifndef") value = !value;
+        }
+        input.conditions.push_back({value, value});
+    } else if (name == "elif" || name == "else" || name == "endif") {
+        if (input.conditions.empty()) {
+            reportError(ErrorType::ERR_INVALID, "#" + name + " without #if");
+            return false;
+        }
+        auto &condition = input.conditions.back();
+        if (name == "endif") {
+            input.conditions.pop_back();
+        } else if (condition.seenElse) {
+            reportError(ErrorType::ERR_INVALID, "#" + name + " after #else");
+        } else if (name == "else") {
+            condition.active = !condition.taken;
+            condition.taken = condition.seenElse = true;
+        } else {
+            condition.active = !condition.taken && evaluate(tokens, args);
+            condition.taken |= condition.active;
+        }
+    } else if (!input.active()) {
+        return false;
+    } else if (name == "define" || name == "undef") {
+        if (args == tokens.size() || tokens[args].kind != Token::Identifier)
+            reportError(ErrorType::ERR_INVALID, "no macro name given in #" + name + " directive");
+        else if (name == "define")
+            defineMacro(tokens, args);
+        else
+            macros.erase(tokens[args].text);
+    } else if (name == "include") {
+        return include(std::vector<Token>(tokens.begin() + args, tokens.end()));
+    } else if (name == "error") {
+        reportError(ErrorType::ERR_INVALID, "#error " + restOfLine());
+    } else if (name == "warning") {
+        ::P4::warning(ErrorType::WARN_FAILED, "%1%:%2%: #warning %3%", input.path.string(),
+                      input.lineStart, restOfLine());
+    } else if (name == "pragma" && args < tokens.size() && tokens[args].text == "once") {
+        std::error_code ec;
+        onceFiles.insert(std::filesystem::weakly_canonical(input.path, ec).string());
+    } else {
+        // Other directives, such as #pragma and #line, are for the compiler.
+        for (auto &token : tokens) output += token.text;
+    }
+    return false;
+}
+
+bool Preprocessor::include(std::vector<Token> tokens) {
+    auto &input = *inputs.back();
+    std::string name;
+    bool quoted = false;
+    for (int attempt = 0; attempt < 2 && name.empty(); ++attempt) {
+        auto first = std::find_if(tokens.begin(), tokens.end(),
+                                  [](const Token &token) { return !token.isSpace(); });
+        if (first == tokens.end()) break;
+        if (first->kind == Token::String && first->text.size() >= 2) {
+            name = first->text.substr(1, first->text.size() - 2);
+            quoted = true;
+        } else if (first->is("<")) {
+            auto last = std::find_if(first, tokens.end(),
+                                     [](const Token &token) { return token.is(">"); });
+            if (last == tokens.end()) break;
+            for (auto it = first + 1; it != last; ++it) name += it->text;
+        } else {
+            tokens = expand(std::move(tokens), false);
+        }
+    }
+    if (name.empty()) {
+        reportError(ErrorType::ERR_INVALID, "#include expects \"FILENAME\" or <FILENAME>");
+        return false;
+    }
+    if (inputs.size() > 200) {
+        reportError(ErrorType::ERR_INVALID, "#include nested too deeply");
+        return false;
+    }
+
+    std::vector<std::filesystem::path> candidates;
+    std::filesystem::path path(name);
+    if (path.is_absolute()) {
+        candidates.push_back(path);
+    } else {
+        if (quoted) candidates.push_back(input.path.parent_path() / path);
+        for (auto &dir : includePaths) candidates.push_back(dir / path);
+    }
+    for (auto &candidate : candidates) {
+        auto file = readFile(candidate);
+        if (!file) continue;
+        std::error_code ec;
+        auto canonical = std::filesystem::weakly_canonical(candidate, ec);
+        if (onceFiles.count(canonical.string())) return false;
+        processFile(candidate, file->text, 1);
+        writeLineMarker(input.line, input.path, 2);
+        return true;
+    }
+    reportError(ErrorType::ERR_NOT_FOUND, name + ": No such file or directory");
+    return false;
+}
+
+void Preprocessor::defineMacro(const std::vector<Token> &tokens, size_t name) {
+    Macro macro;
+    size_t index = name + 1;
+    if (index < tokens.size() && tokens[index].is("(")) {
+        macro.functionLike = true;
+        bool valid = false;
+        for (++index; index < tokens.size(); ++index) {
+            auto &token = tokens[index];
+            if (token.isSpace() || token.is(",")) continue;
+            if (token.is(")")) {
+                valid = true;
+                break;
+            }
+            if (macro.variadic) break;
+            if (token.is("...")) {
+                macro.variadic = true;
+                macro.params.push_back("__VA_ARGS__");
+            } else if (token.kind == Token::Identifier) {
+                macro.params.push_back(token.text);
+                if (index + 1 < tokens.size() && tokens[index + 1].is("...")) {
+                    macro.variadic = true;
+                    ++index;
+                }
+            } else {
+                break;
+            }
+        }
+        if (!valid) {
+            reportError(ErrorType::ERR_INVALID,
+                        "invalid parameter list in the definition of " + tokens[name].text);
+            return;
+        }
+        ++index;
+    }
+
+    // Comments are replaced by spaces, and spaces are collapsed.
+    for (; index < tokens.size(); ++index) {
+        auto &token = tokens[index];
+        if (!token.isSpace())
+            macro.body.push_back(token);
+        else if (!macro.body.empty() && !macro.body.back().isSpace())
+            macro.body.emplace_back(Token::Space, " ");
+    }
+    while (!macro.body.empty() && macro.body.back().isSpace()) macro.body.pop_back();
+    if (!macro.body.empty() && (macro.body.front().is("##") || macro.body.back().is("##")))
+        reportError(ErrorType::ERR_INVALID,
+                    "'##' cannot appear at either end of a macro expansion");
+    macros[tokens[name].text] = std::move(macro);
+}
+
+bool Preprocessor::evaluate(const std::vector<Token> &tokens, size_t start) {
+    std::vector<Token> expression;
+    for (size_t i = start; i < tokens.size(); ++i) {
+        if (tokens[i].kind != Token::Identifier || tokens[i].text != "defined") {
+            expression.push_back(tokens[i]);
+            continue;
+        }
+        auto skipSpaces = [&](size_t index) {
+            do ++index;
+            while (index < tokens.size() && tokens[index].isSpace());
+            return index;
+        };
+        size_t index = skipSpaces(i);
+        bool parenthesized = index < tokens.size() && tokens[index].is("(");
+        if (parenthesized) index = skipSpaces(index);
+        size_t name = index;
+        if (parenthesized && index < tokens.size()) index = skipSpaces(index);
+        if (name >= tokens.size() || tokens[name].kind != Token::Identifier ||
+            (parenthesized && (index == tokens.size() || !tokens[index].is(")")))) {
+            reportError(ErrorType::ERR_INVALID, "operator \"defined\" requires an identifier");
+            return false;
+        }
+        i = parenthesized ? index : name;
+        expression.emplace_back(Token::Number, macros.count(tokens[name].text) ? "1" : "0");
+    }
+
+    // Identifiers left after the expansion of macros are 0
+    std::vector<std::string> values;
+    for (auto &token : expand(std::move(expression), false)) {
+        if (token.isSpace() || token.kind == Token::Placemarker) continue;
+        values.push_back(token.kind == Token::Identifier ? "0" : token.text);
+    }
+    try {
+        return ExpressionEvaluator(values).evaluate() != 0;
+    } catch (const std::runtime_error &e) {
+        reportError(ErrorType::ERR_INVALID, std::string("#if: ") + e.what());
+        return false;
+    }
+}
+
+std::vector<Preprocessor::Token> Preprocessor::expand(std::vector<Token> tokens,
+                                                      bool fetchLines) {
+    std::vector<Token> result;
+    std::deque<Token> pending(std::make_move_iterator(tokens.begin()),
+                              std::make_move_iterator(tokens.end()));
+    while (!pending.empty()) {
+        Token token = std::move(pending.front());
+        pending.pop_front();
+        if (token.kind != Token::Identifier || token.noExpand) {
+            result.push_back(std::move(token));
+            continue;
+        }
+        if (token.text == "__LINE__" || token.text == "__FILE__") {
+            auto &input = *inputs.back();
+            result.emplace_back(token.text == "__LINE__" ? Token::Number : Token::String,
+                                token.text == "__LINE__" ? std::to_string(input.lineStart)
+                                                         : quote(input.path.string()));
+            continue;
+        }
+        auto it = macros.find(token.text);
+        if (it == macros.end()) {
+            result.push_back(std::move(token));
+            continue;
+        }
+        if (token.hideSet && token.hideSet->count(token.text)) {
+            token.noExpand = true;
+            result.push_back(std::move(token));
+            continue;
+        }
+
+        // Copies the macro, which can be redefined while its arguments are expanded.
+        Macro macro = it->second;
+        std::vector<std::vector<Token>> args;
+        if (macro.functionLike) {
+            size_t next = 0;
+            while (true) {
+                while (next < pending.size() && (pending[next].isSpace() ||
+                                                 pending[next].kind == Token::Placemarker))
+                    ++next;
+                if (next < pending.size() || !fetchLines || !fetchArgumentLine(pending)) break;
+            }
+            if (next == pending.size() || !pending[next].is("(")) {
+                result.push_back(std::move(token));
+                continue;
+            }
+            pending.erase(pending.begin(), pending.begin() + next + 1);
+            if (!collectArguments(pending, macro, token.text, args, fetchLines)) continue;
+        }
+        auto body = substitute(macro, args, token);
+        pending.insert(pending.begin(), std::make_move_iterator(body.begin()),
+                       std::make_move_iterator(body.end()));
+    }
+    return result;
+}
+
+bool Preprocessor::collectArguments(std::deque<Token> &pending, const Macro &macro,
+                                    const std::string &name,
+                                    std::vector<std::vector<Token>> &args, bool fetchLines) {
+    args.emplace_back();
+    unsigned depth = 0;
+    while (true) {
+        if (pending.empty() && !(fetchLines && fetchArgumentLine(pending))) {
+            reportError(ErrorType::ERR_INVALID,
+                        "unterminated argument list invoking macro \"" + name + "\"");
+            return false;
+        }
+        Token token = std::move(pending.front());
+        pending.pop_front();
+        if (token.is(")") && depth == 0) break;
+        if (token.is("(")) ++depth;
+        if (token.is(")")) --depth;
+        if (token.is(",") && depth == 0 &&
+            !(macro.variadic && args.size() == macro.params.size())) {
+            args.emplace_back();
+            continue;
+        }
+        if (token.kind == Token::Comment) token = Token(Token::Space, " ");
+        args.back().push_back(std::move(token));
+    }
+
+    for (auto &arg : args) {
+        while (!arg.empty() && arg.back().isSpace()) arg.pop_back();
+        auto first = std::find_if(arg.begin(), arg.end(),
+                                  [](const Token &token) { return !token.isSpace(); });
+        arg.erase(arg.begin(), first);
+    }
+    if (args.size() == 1 && args[0].empty() && macro.params.empty()) args.clear();
+    if (macro.variadic && args.size() + 1 == macro.params.size()) args.emplace_back();
+    if (args.size() != macro.params.size()) {
+        reportError(ErrorType::ERR_INVALID,
+                    "macro \"" + name + "\" requires " + std::to_string(macro.params.size()) +
+                        " arguments, but " + std::to_string(args.size()) + " given");
+        return false;
+    }
+    return true;
+}
+
+std::vector<Preprocessor::Token> Preprocessor::substitute(
+    const Macro &macro, const std::vector<std::vector<Token>> &args, const Token &name) {
+    auto &body = macro.body;
+    auto param = [&](const Token &token) -> int {
+        if (token.kind != Token::Identifier) return -1;
+        auto it = std::find(macro.params.begin(), macro.params.end(), token.text);
+        return it == macro.params.end() ? -1 : static_cast<int>(it - macro.params.begin());
+    };
+    auto nextToken = [&](size_t i) {
+        do ++i;
+        while (i < body.size() && body[i].isSpace());
+        return i;
+    };
+    auto trimSpaces = [](std::vector<Token> &tokens) {
+        while (!tokens.empty() && tokens.back().isSpace()) tokens.pop_back();
+    };
+
+    std::vector<Token> result;
+    for (size_t i = 0; i < body.size(); ++i) {
+        const auto &token = body[i];
+        size_t next = nextToken(i);
+        if (macro.functionLike && token.is("#") && next < body.size() && param(body[next]) >= 0) {
+            // Only the strings of the argument are escaped
+            std::string text;
+            for (auto &argToken : args[param(body[next])]) {
+                if (argToken.isSpace()) {
+                    text += ' ';
+                } else if (argToken.kind == Token::String) {
+                    auto quoted = quote(argToken.text);
+                    text += quoted.substr(1, quoted.size() - 2);
+                } else {
+                    text += argToken.text;
+                }
+            }
+            result.emplace_back(Token::String, "\"" + text + "\"");
+            i = next;
+        } else if (token.is("##") && next < body.size()) {
+            trimSpaces(result);
+            std::vector<Token> right;
+            int index = param(body[next]);
+            if (index < 0) {
+                right.push_back(body[next]);
+            } else if (args[index].empty()) {
+                // GNU extension: `, ## __VA_ARGS__` removes the comma if there is no argument
+                if (macro.variadic && index + 1 == static_cast<int>(macro.params.size()) &&
+                    !result.empty() && result.back().is(","))
+                    result.pop_back();
+                i = next;
+                continue;
+            } else {
+                right = args[index];
+            }
+            if (result.empty() || result.back().kind == Token::Placemarker) {
+                if (!result.empty()) result.pop_back();
+                result.insert(result.end(), right.begin(), right.end());
+            } else if (!(macro.variadic && index + 1 == static_cast<int>(macro.params.size()) &&
+                         result.back().is(","))) {
+                auto pasted = tokenize(result.back().text + right.front().text);
+                if (pasted.size() != 1)
+                    reportError(ErrorType::ERR_INVALID,
+                                "pasting \"" + result.back().text + "\" and \"" +
+                                    right.front().text + "\" does not give a valid token");
+                result.pop_back();
+                result.insert(result.end(), pasted.begin(), pasted.end());
+                result.insert(result.end(), right.begin() + 1, right.end());
+            } else {
+                result.insert(result.end(), right.begin(), right.end());
+            }
+            i = next;
+        } else if (int index = param(token); index >= 0) {
+            if (next < body.size() && body[next].is("##")) {
+                if (args[index].empty())
+                    result.emplace_back(Token::Placemarker, "");
+                else
+                    result.insert(result.end(), args[index].begin(), args[index].end());
+            } else {
+                auto expanded = expand(args[index], false);
+                result.insert(result.end(), expanded.begin(), expanded.end());
+            }
+        } else {
+            result.push_back(token);
+        }
+    }
+
+    auto hideSet = std::make_shared<std::set<std::string>>();
+    if (name.hideSet) *hideSet = *name.hideSet;
+    hideSet->insert(name.text);
+    std::shared_ptr<const std::set<std::string>> shared = hideSet;
+    result.erase(std::remove_if(result.begin(), result.end(),
+                                [](const Token &token) {
+                                    return token.kind == Token::Placemarker;
+                                }),
+                 result.end());
+    for (auto &token : result) {
+        if (!token.hideSet || token.hideSet->empty()) {
+            token.hideSet = shared;
+        } else {
+            auto merged = std::make_shared<std::set<std::string>>(*token.hideSet);
+            merged->insert(hideSet->begin(), hideSet->end());
+            token.hideSet = std::move(merged);
+        }
+    }
+    if (result.empty()) result.emplace_back(Token::Placemarker, "");
+    result.front().boundary = result.back().boundary = true;
+    return result;
+}
+
+void Preprocessor::write(const std::vector<Token> &tokens) {
+    bool boundary = false;
+    for (auto &token : tokens) {
+        boundary |= token.boundary;
+        if (token.text.empty()) continue;
+        if (boundary && !output.empty() && wouldPaste(output.back(), token.text.front()))
+            output += ' ';
+        output += token.text;
+        boundary = token.boundary;
+    }
+}
+
+void Preprocessor::writeLineMarker(unsigned line, const std::filesystem::path &path, int flag) {
+    if (!output.empty() && output.back() != '\n') output += '\n';
+    output += "# " + std::to_string(line) + " " + quote(path.string());
+    if (flag) output += " " + std::to_string(flag);
+    output += '\n';
+}
+
+void Preprocessor::reportError(int kind, std::string_view message) const {
+    if (inputs.empty()) {
+        ::P4::error(kind, "%1%", std::string(message));
+        return;
+    }
+    auto &input = *inputs.back();
+    ::P4::error(kind, "%1%:%2%: %3%", input.path.string(), input.lineStart, std::string(message));
+}
+
+}  // namespace P4
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FRONTENDS_COMMON_PREPROCESSOR_H_
+#define FRONTENDS_COMMON_PREPROCESSOR_H_
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace P4 {
+
+/**
+An in-process C preprocessor for P4 programs, used instead of the external
+`cpp` with --builtin-preprocessor. It implements the subset of the C
+preprocessor used by P4 programs and by the p4include files:
+
+  - #include "file" and #include <file>, with the -I search paths;
+  - object-like and function-like macros, with #, ## and __VA_ARGS__,
+    and the predefined __FILE__ and __LINE__;
+  - #undef, #if, #ifdef, #ifndef, #elif, #else and #endif, with the integer
+    expressions and defined() of the C preprocessor;
+  - #error, #warning and #pragma once.
+
+Like `cpp -C -undef -x assembler-with-cpp`, it keeps comments, has no other
+predefined macro, does not treat apostrophes as character literals, and
+passes other #pragma, #line and unknown directives through. The output has
+line markers `# line "file" flags` for the parser, and keeps the line
+numbers of each file in sync with its source.
+
+Files are read in memory through a process-wide cache keyed by canonical path,
+so each include file is read once per process while it does not change.
+ */
+class Preprocessor {
+ public:
+    explicit Preprocessor(std::vector<std::filesystem::path> includePaths)
+        : includePaths(std::move(includePaths)) {}
+
+    /// Defines a macro as the -D option: "NAME", "NAME=body" or "NAME(params)=body".
+    void define(std::string_view definition);
+    /// Undefines a macro, as the -U option.
+    void undefine(std::string_view name) { macros.erase(std::string(name)); }
+
+    /// Preprocesses @p file. Errors are reported with ::P4::error.
+    /// @return the preprocessed text, or std::nullopt if the file cannot be read.
+    std::optional<std::string> preprocess(const std::filesystem::path &file);
+    /// Preprocesses @p text, as the contents of a file named @p name.
+    std::string preprocess(std::string_view name, std::string_view text);
+
+ private:
+    struct Token {
+        enum Kind { Space, Comment, Identifier, Number, String, Punct, Placemarker };
+        Kind kind;
+        std::string text;
+        /// Names of the macros whose expansion produced this token, which are not expanded
+        /// again when the token is rescanned.
+        std::shared_ptr<const std::set<std::string>> hideSet;
+        /// Identifier of a macro that was found in its hide set: it is never expanded.
+        bool noExpand = false;
+        /// First or last token of a macro expansion: a space is written next to it if it
+        /// would otherwise be pasted with the adjacent token.
+        bool boundary = false;
+
+        Token(Kind kind, std::string text) : kind(kind), text(std::move(text)) {}
+        bool is(std::string_view punct) const { return kind == Punct && text == punct; }
+        bool isSpace() const { return kind == Space || kind == Comment; }
+    };
+
+    struct Macro {
+        bool functionLike = false;
+        bool variadic = false;
+        std::vector<std::string> params;
+        std::vector<Token> body;
+    };
+
+    struct Condition {
+        /// The current branch is being processed.
+        bool active;
+        /// A branch was taken, or the enclosing one is not active.
+        bool taken;
+        bool seenElse = false;
+    };
+
+    /// A file being preprocessed.
+    struct Input {
+        std::filesystem::path path;
+        std::string_view text;
+        size_t pos = 0;
+        /// Line of the next character, and first line of the line being processed, which
+        /// spans several lines with backslashes, block comments, or macro arguments.
+        unsigned line = 1, lineStart = 1;
+        std::vector<Condition> conditions;
+
+        bool active() const { return conditions.empty() || conditions.back().active; }
+    };
+
+    std::vector<std::filesystem::path> includePaths;
+    std::unordered_map<std::string, Macro> macros;
+    /// Files with #pragma once that were included.
+    std::unordered_set<std::string> onceFiles;
+    std::string output;
+    /// Files being preprocessed, innermost last.
+    std::vector<Input *> inputs;
+
+    static std::vector<Token> tokenize(std::string_view text);
+    /// Reads the next line of the current file, without its newline.
+    bool nextLine(std::vector<Token> &tokens);
+    /// Appends the next line to @p pending, for arguments of a macro that span several
+    /// lines, unless it is a directive.
+    bool fetchArgumentLine(std::deque<Token> &pending);
+
+    void processFile(const std::filesystem::path &path, std::string_view text, int flag);
+    /// @return true if the directive wrote a line marker for the following line.
+    bool directive(std::vector<Token> &tokens);
+    /// @return true if the file was included.
+    bool include(std::vector<Token> tokens);
+    void defineMacro(const std::vector<Token> &tokens, size_t name);
+    bool evaluate(const std::vector<Token> &tokens, size_t start);
+
+    /// Expands the macros in @p tokens. With @p fetchLines, the arguments of a macro can
+    /// continue on the following lines of the file.
+    std::vector<Token> expand(std::vector<Token> tokens, bool fetchLines);
+    bool collectArguments(std::deque<Token> &pending, const Macro &macro, const std::string &name,
+                          std::vector<std::vector<Token>> &args, bool fetchLines);
+    std::vector<Token> substitute(const Macro &macro, const std::vector<std::vector<Token>> &args,
+                                  const Token &name);
+
+    void write(const std::vector<Token> &tokens);
+    void writeLineMarker(unsigned line, const std::filesystem::path &path, int flag);
+    void reportError(int kind, std::string_view message) const;
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_PREPROCESSOR_H_ */
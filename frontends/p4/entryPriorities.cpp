@@ -5,6 +5,8 @@
 
 #include "entryPriorities.h"
 
+#include <unordered_map>
+
 #include "coreLibrary.h"
 
 namespace P4 {
@@ -101,7 +103,8 @@ const IR::Node *EntryPriorities::preorder(IR::EntriesList *entries) {
 
     // Some priorities specified.
 
-    std::map<size_t, const IR::Entry *> usedPriorities;
+    std::unordered_map<size_t, const IR::Entry *> usedPriorities;
+    usedPriorities.reserve(entries->size());
     size_t previousPriority = 0;
     bool out_of_order = false;
     for (size_t i = 0; i < entries->size(); ++i) {
@@ -124,12 +127,11 @@ const IR::Node *EntryPriorities::preorder(IR::EntriesList *entries) {
                                           priority, entry->keys, entry->action, entry->singleton);
             entries->entries[i] = newEntry;
         }
-        auto previous = usedPriorities.find(currentPriority);
-        if (previous != usedPriorities.end()) {
+        auto [previous, inserted] = usedPriorities.emplace(currentPriority, entries->entries[i]);
+        if (!inserted) {
             warn(ErrorType::WARN_DUPLICATE_PRIORITIES, "%1% and %2% have the same priority %3%",
                  previous->second, entries->entries[i], currentPriority);
         }
-        usedPriorities.emplace(currentPriority, entries->entries[i]);
 
         size_t nextPriority;
         if (largestWins) {
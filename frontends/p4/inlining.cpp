@@ -5,6 +5,8 @@
 
 #include "inlining.h"
 
+#include <unordered_map>
+
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/callGraph.h"
 #include "frontends/p4/def_use.h"
@@ -313,6 +315,7 @@ const T *PerInstanceSubstitutions::rename(ReferenceMap *refMap, const IR::Node *
 
 void InlineList::analyze() {
     P4::CallGraph<const IR::IContainer *> cg("Call-graph");
+    inlining = false;
 
     for (auto m : inlineMap) {
         auto inl = m.second;
@@ -332,17 +335,18 @@ void InlineList::analyze() {
             continue;
         }
         cg.calls(inl->caller, inl->callee);
+        inlining = true;
     }
 
     // must inline from leaves up
     std::vector<const IR::IContainer *> order;
     cg.sort(order);
+    std::unordered_map<const IR::IContainer *, std::vector<CallInfo *>> byCaller;
+    for (auto m : inlineMap) byCaller[m.second->caller].push_back(m.second);
     for (auto c : order) {
-        // This is quadratic, but hopefully the call graph is not too large
-        for (auto m : inlineMap) {
-            auto inl = m.second;
-            if (inl->caller == c) toInline.push_back(inl);
-        }
+        auto it = byCaller.find(c);
+        if (it == byCaller.end()) continue;
+        toInline.insert(toInline.end(), it->second.begin(), it->second.end());
     }
 
     std::reverse(toInline.begin(), toInline.end());
@@ -372,11 +376,13 @@ void DiscoverInlining::postorder(const IR::MethodCallStatement *statement) {
     CHECK_NULL(am);
     if (!am->applyObject->is<IR::Type_Control>() && !am->applyObject->is<IR::Type_Parser>()) return;
     auto instantiation = am->object->to<IR::Declaration_Instance>();
-    if (instantiation != nullptr)
+    if (instantiation != nullptr) {
         inlineList->addInvocation(instantiation, statement);
-    else
+    } else {
         BUG_CHECK(am->object->is<IR::Parameter>(), "%1% expected a constructor parameter",
                   am->object);
+        inlineList->parameterInvocations = true;
+    }
 }
 
 void DiscoverInlining::visit_all(const IR::Block *block) {
@@ -302,8 +302,15 @@ class InlineList {
     ordered_map<const IR::Declaration_Instance *, CallInfo *> inlineMap;
     std::vector<CallInfo *> toInline;  // sorted in order of inlining
     const bool allowMultipleCalls = true;
+    /// True if the last analysis found instances to inline.
+    bool inlining = false;
 
  public:
+    /// Set when a control or parser applies one of its constructor parameters.  The instance
+    /// passed as argument can only be inlined once that control or parser has been inlined
+    /// in its caller, in another round of inlining.
+    bool parameterInvocations = false;
+
     void addInstantiation(const IR::IContainer *caller, const IR::IContainer *callee,
                           const IR::Declaration_Instance *instantiation) {
         CHECK_NULL(caller);
@@ -316,6 +323,14 @@ class InlineList {
 
     size_t size() const { return inlineMap.size(); }
 
+    /// Forgets the instantiations found by a previous round of inlining.
+    void clear() {
+        inlineMap.clear();
+        toInline.clear();
+        inlining = false;
+        parameterInvocations = false;
+    }
+
     void addInvocation(const IR::Declaration_Instance *instance,
                        const IR::MethodCallStatement *statement) {
         CHECK_NULL(instance);
@@ -338,6 +353,8 @@ class InlineList {
 
     void analyze();
     InlineSummary *next();
+    /// @returns true if another round of inlining may find more to inline.
+    bool needsAnotherRound() const { return inlining && parameterInvocations; }
 };
 
 /// Must be run after an evaluator; uses the blocks to discover caller/callee relationships.
@@ -369,6 +386,7 @@ class DiscoverInlining : public Inspector {
     Visitor::profile_t init_apply(const IR::Node *node) override {
         toplevel = evaluator->getToplevelBlock();
         CHECK_NULL(toplevel);
+        inlineList->clear();
         return Inspector::init_apply(node);
     }
     void visit_all(const IR::Block *block);
@@ -431,12 +449,16 @@ class InlinePass : public PassManager {
                        new RemoveAllUnusedDeclarations(policy)}) {
         setName("InlinePass");
     }
+
+    bool needsAnotherRound() const { return toInline.needsAnotherRound(); }
 };
 
 /**
 Performs inlining as many times as necessary.  Most frequently once
 will be enough.  Multiple iterations are necessary only when instances are
-passed as arguments using constructor arguments.
+passed as arguments using constructor arguments; another round is only run
+in that case, instead of re-checking the whole program until it no longer
+changes.
 */
 class Inline : public PassManager {
     static std::set<cstring> noPropagateAnnotations;
@@ -447,13 +469,18 @@ class Inline : public PassManager {
            EvaluatorPass *evaluator = nullptr) {
         refMap.setIsV1(P4CContext::get().options().isv1());
         auto *evInstance = evaluator ? evaluator : new EvaluatorPass(&refMap, typeMap);
+        auto *inlinePass =
+            new InlinePass(&refMap, typeMap, evInstance, policy, optimizeParserInlining);
         addPasses({
             evInstance,
-            new PassRepeated(
-                {new InlinePass(&refMap, typeMap, evInstance, policy, optimizeParserInlining),
+            new PassRepeatUntil(
+                {inlinePass,
                  // After inlining the output of the evaluator changes, so we have to
                  // run it again
-                 evInstance}),
+                 evInstance},
+                [inlinePass]() {
+                    return ::P4::errorCount() > 0 || !inlinePass->needsAnotherRound();
+                }),
         });
         setName("Inline");
     }
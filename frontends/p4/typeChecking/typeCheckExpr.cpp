@@ -412,6 +412,42 @@ TypeInferenceBase::PreorderResult TypeInferenceBase::preorder(const IR::EntriesL
     return {el, false};
 }
 
+const IR::ListExpression *TypeInferenceBase::typeConstantEntryKeys(
+    const IR::Type_BaseList *keyTuple, const IR::ListExpression *keyset) {
+    if (keyset->components.size() != keyTuple->components.size()) return nullptr;
+    IR::ListExpression *result = nullptr;
+    IR::Vector<IR::Type> components;
+    for (size_t i = 0; i < keyset->components.size(); ++i) {
+        auto *ke = keyset->components.at(i);
+        auto *keyType = keyTuple->components.at(i);
+        auto *type = getType(ke);
+        if (type == nullptr) return nullptr;
+        if (ke->is<IR::DefaultExpression>()) {
+            components.push_back(type);
+            continue;
+        }
+        auto *cst = ke->to<IR::Constant>();
+        if (cst == nullptr || !keyType->is<IR::Type_Bits>()) return nullptr;
+        if (type->is<IR::Type_InfInt>()) {
+            if (readOnly) return nullptr;
+            auto *typed = new IR::Constant(cst->srcInfo, keyType, cst->value, cst->base);
+            setType(typed, keyType);
+            setCompileTimeConstant(typed);
+            if (result == nullptr) result = keyset->clone();
+            result->components[i] = typed;
+        } else if (!typeMap->equivalent(type, keyType)) {
+            return nullptr;
+        }
+        components.push_back(keyType);
+    }
+    if (result == nullptr) return keyset;
+    auto *type = canonicalize(new IR::Type_List(result->srcInfo, std::move(components)));
+    if (type == nullptr) return nullptr;
+    setType(result, type);
+    setCompileTimeConstant(result);
+    return result;
+}
+
 /**
  *  typecheck a table initializer entry
  *
@@ -467,13 +503,18 @@ const IR::Node *TypeInferenceBase::postorder(const IR::Entry *entry) {
         return entry;
     }
 
-    TypeVariableSubstitution *tvs =
-        unifyCast(entry, keyTuple, entryKeyType,
-                  "Table entry has type '%1%' which is not the expected type '%2%'",
-                  {keyTuple, entryKeyType});
-    if (tvs == nullptr) return entry;
-    ConstantTypeSubstitution cts(tvs, typeMap, this);
-    auto ks = cts.convert(keyset, getChildContext());
+    const IR::Expression *ks = nullptr;
+    if (auto *tl = keyTuple->to<IR::Type_BaseList>(); tl && !entry->singleton)
+        ks = typeConstantEntryKeys(tl, keyset);
+    if (ks == nullptr) {
+        TypeVariableSubstitution *tvs =
+            unifyCast(entry, keyTuple, entryKeyType,
+                      "Table entry has type '%1%' which is not the expected type '%2%'",
+                      {keyTuple, entryKeyType});
+        if (tvs == nullptr) return entry;
+        ConstantTypeSubstitution cts(tvs, typeMap, this);
+        ks = cts.convert(keyset, getChildContext());
+    }
     if (::P4::errorCount() > 0) return entry;
 
     if (ks != keyset)
@@ -194,6 +194,11 @@ class TypeInferenceBase : public virtual Visitor, public ResolutionContext {
     /// or for actions in the entries list.  Returns the action list element
     /// on success.
     const IR::ActionListElement *validateActionInitializer(const IR::Expression *actionCall);
+    /// Types the keys of a table entry made only of constants and don't cares for bit<> key
+    /// fields, which is what tables with many entries are made of, without unification.
+    /// Returns nullptr if the keys are not of that form; the general rules apply then.
+    const IR::ListExpression *typeConstantEntryKeys(const IR::Type_BaseList *keyTuple,
+                                                    const IR::ListExpression *keyset);
     bool containsActionEnum(const IR::Type *type) const;
 
     /// Check if the underlying type for enum is bit<> or int<> and emit error if it is not.
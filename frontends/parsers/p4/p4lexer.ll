@@ -62,11 +62,11 @@ using Parser = P4::P4Parser;
                         driver.saveState = NORMAL;
                         return makeToken(END_PRAGMA); }
 [\n]                  { BEGIN INITIAL; }
-"//".*                { driver.onReadComment(yytext+2, true); }
+"//".*                { driver.onReadComment(true); }
 "/*"                  { BEGIN COMMENT; }
 <COMMENT>([^*]|[*]+[^/*])*[*]+"/" {
                          /* http://www.cs.dartmouth.edu/~mckeeman/cs118/assignments/comment.html */
-                         driver.onReadComment(yytext, false);
+                         driver.onReadComment(false);
                          if (driver.saveState == PRAGMA_LINE) {
                              // If the comment contains a newline, end the pragma line.
                              for (int i = 0; i < strlen(yytext); i++) {
@@ -91,8 +91,8 @@ void AbstractParserDriver::onReadLineNumber(const char *text) {
     }
 }
 
-void AbstractParserDriver::onReadComment(const char *text, bool lineComment) {
-    sources->addComment(yylloc, lineComment, cstring(text));
+void AbstractParserDriver::onReadComment(bool lineComment) {
+    sources->addComment(yylloc, lineComment);
 }
 
 void AbstractParserDriver::onReadFileName(const char *text) {
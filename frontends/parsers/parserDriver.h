@@ -39,11 +39,10 @@ class AbstractParserDriver {
     ////////////////////////////////////////////////////////////////////////////
 
     /**
-     * Notify that the lexer has read a comment.
-     * @param text         The body of the comment, without the comment termination
+     * Notify that the lexer has read a comment, which is the last token read.
      * @param lineComment  If true this is a line comment starting with //
      */
-    void onReadComment(const char *text, bool lineComment);
+    void onReadComment(bool lineComment);
 
     /// Notify that the lexer read a token. @text is the matched source text.
     void onReadToken(const char *text);
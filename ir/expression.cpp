@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <limits>
 #include <ostream>
 
 #include "absl/container/flat_hash_map.h"
@@ -86,6 +87,39 @@ void IR::Constant::handleOverflow(bool noWarning) {
     }
 
     int width = tb->size;
+    if (width > 0 && width <= 64 && value >= std::numeric_limits<int64_t>::min() &&
+        value <= std::numeric_limits<int64_t>::max()) {
+        // Most constants fit in 64 bits; check them with machine integers.
+        auto v = static_cast<int64_t>(value);
+        uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        uint64_t masked = static_cast<uint64_t>(v) & mask;
+        if (tb->isSigned) {
+            int64_t max = width == 64 ? std::numeric_limits<int64_t>::max()
+                                      : (int64_t(1) << (width - 1)) - 1;
+            if (v < -max - 1 || v > max) {
+                if (!noWarning)
+                    warning(ErrorType::WARN_OVERFLOW, "%1%: signed value does not fit in %2% bits",
+                            this, width);
+                // width < 64 here
+                value = masked > static_cast<uint64_t>(max)
+                            ? static_cast<int64_t>(masked) - (int64_t(1) << width)
+                            : static_cast<int64_t>(masked);
+            }
+        } else {
+            if (v < 0) {
+                if (!noWarning)
+                    warning(ErrorType::WARN_MISMATCH, "%1%: negative value with unsigned type",
+                            this);
+            } else if (masked != static_cast<uint64_t>(v)) {
+                if (!noWarning)
+                    warning(ErrorType::WARN_OVERFLOW, "%1%: value does not fit in %2% bits", this,
+                            width);
+            }
+            value = masked;
+        }
+        return;
+    }
+
     big_int one = 1;
     big_int mask = Util::mask(width);
 
@@ -148,9 +182,7 @@ IR::Constant IR::Constant::operator-(const IR::Constant &c) const {
 
 IR::Constant IR::Constant::operator-() const { return IR::Constant(-value); }
 
-IR::Constant IR::Constant::GetMask(unsigned width) {
-    return (IR::Constant(1) << width) - IR::Constant(1);
-}
+IR::Constant IR::Constant::GetMask(unsigned width) { return IR::Constant(Util::mask(width)); }
 
 const IR::Constant *IR::Constant::get(const IR::Type *t, big_int v, Util::SourceInfo si) {
     // Only cache bits with width lower than 16 bit to restrict the size of the cache.
@@ -113,7 +113,8 @@ Util::JsonObject *IR::Node::sourceInfoJsonObj() const {
     unsigned lineNumber, columnNumber;
     cstring fName = prepareSourceInfoForJSON(si, &lineNumber, &columnNumber);
     if (fName == nullptr) {
-        if (si.line == -1) {
+        auto *loaded = srcInfo.fromJson();
+        if (loaded == nullptr || loaded->line == -1) {
             // -1 is default value for objects when SourceInfo
             // was not read from jsonFile using "--fromJSON" flag
             return nullptr;
@@ -121,10 +122,10 @@ Util::JsonObject *IR::Node::sourceInfoJsonObj() const {
             // Added source_info for jsonObject when "--fromJSON" flag is used
             // which parameters are saved in srcInfo fileds(filename, line, column and srcBrief)
             auto json1 = new Util::JsonObject();
-            json1->emplace("filename", srcInfo.filename);
-            json1->emplace("line", srcInfo.line);
-            json1->emplace("column", srcInfo.column);
-            json1->emplace("source_fragment", srcInfo.srcBrief);
+            json1->emplace("filename", loaded->filename);
+            json1->emplace("line", loaded->line);
+            json1->emplace("column", loaded->column);
+            json1->emplace("source_fragment", loaded->srcBrief);
             return json1;
         }
     } else {
@@ -156,10 +157,12 @@ void IR::Node::sourceInfoToJSON(JSONGenerator &json) const {
 
 void IR::Node::sourceInfoFromJSON(JSONLoader &json) {
     if (auto si = JSONLoader(json, "Source_Info")) {
-        si.load("filename", srcInfo.filename);
-        si.load("line", srcInfo.line);
-        si.load("column", srcInfo.column);
-        si.load("source_fragment", srcInfo.srcBrief);
+        Util::SourceInfo::JsonSourceInfo loaded;
+        si.load("filename", loaded.filename);
+        si.load("line", loaded.line);
+        si.load("column", loaded.column);
+        si.load("source_fragment", loaded.srcBrief);
+        srcInfo = Util::SourceInfo(loaded.filename, loaded.line, loaded.column, loaded.srcBrief);
     }
 }
 
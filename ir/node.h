@@ -132,7 +132,8 @@ class Node : public virtual INode {
         sink.Append(n->toString());
     }
 
-    DECLARE_TYPEINFO_WITH_TYPEID(Node, NodeKind::Node, INode);
+    DECLARE_TYPEINFO_WITH_TYPEID_INTERVAL(Node, NodeKind::Node, NodeKindTree.last, NodeKindTree,
+                                          INode);
 };
 
 // simple version of dbprint
@@ -26,6 +26,7 @@ big_int ripBits(big_int &value, int bits) {
 }
 
 big_int mask(unsigned bits) {
+    if (bits < 64) return (uint64_t(1) << bits) - 1;
     big_int one = 1;
     big_int result = shift_left(one, bits);
     return result - 1;
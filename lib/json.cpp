@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "json.h"
 
+#include <cstdio>
 #include <sstream>
 #include <stdexcept>
 
@@ -210,4 +211,157 @@ JsonObject *JsonObject::emplace_non_null(cstring label, IJson *value) {
     return this;
 }
 
+void JsonWriter::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+void JsonWriter::newline() {
+    buffer += '\n';
+    buffer.append(depth * indent_t::tabsz, ' ');
+}
+
+void JsonWriter::beginValue() {
+    maybeFlush();
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (scopes.empty()) return;
+    auto &scope = scopes.back();
+    if (scope.isObject) throw std::logic_error("JSON object member written without a key");
+    if (!scope.empty) {
+        buffer += ',';
+        if (pretty() && scope.isInline) buffer += ' ';
+    }
+    if (pretty() && !scope.isInline) newline();
+    scope.empty = false;
+}
+
+JsonWriter &JsonWriter::key(std::string_view label) {
+    if (scopes.empty() || !scopes.back().isObject || afterKey)
+        throw std::logic_error("JSON key written outside of an object");
+    maybeFlush();
+    auto &scope = scopes.back();
+    if (!scope.empty) buffer += ',';
+    scope.empty = false;
+    if (pretty()) newline();
+    appendString(label);
+    buffer += pretty() ? " : " : ":";
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    beginValue();
+    buffer += '{';
+    scopes.push_back({true, false});
+    depth++;
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (scopes.empty() || !scopes.back().isObject || afterKey)
+        throw std::logic_error("Unbalanced JSON object");
+    scopes.pop_back();
+    depth--;
+    if (pretty()) newline();
+    buffer += '}';
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(bool inlineValues) {
+    beginValue();
+    buffer += '[';
+    scopes.push_back({false, inlineValues});
+    if (!inlineValues) depth++;
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (scopes.empty() || scopes.back().isObject) throw std::logic_error("Unbalanced JSON array");
+    auto scope = scopes.back();
+    scopes.pop_back();
+    if (!scope.isInline) {
+        depth--;
+        if (pretty() && !scope.empty) newline();
+    }
+    buffer += ']';
+    return *this;
+}
+
+void JsonWriter::appendString(std::string_view s) {
+    // Strings are not escaped, matching JsonValue::serialize.
+    buffer += '"';
+    buffer += s;
+    buffer += '"';
+}
+
+void JsonWriter::appendInteger(long long v) { absl::StrAppend(&buffer, v); }
+
+void JsonWriter::appendInteger(unsigned long long v) { absl::StrAppend(&buffer, v); }
+
+JsonWriter &JsonWriter::value(std::string_view s) {
+    beginValue();
+    appendString(s);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool b) {
+    beginValue();
+    buffer += b ? "true" : "false";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(std::nullptr_t) {
+    beginValue();
+    buffer += "null";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(double v) {
+    beginValue();
+    // Same as the default formatting of std::ostream, used by JsonValue::serialize.
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", v);
+    buffer += buf;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const big_int &v) {
+    beginValue();
+    buffer += v.str();
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const IJson *json) {
+    if (json == nullptr) return value(nullptr);
+    if (auto v = json->to<JsonValue>()) {
+        if (v->isString()) return value(v->getString());
+        if (v->isInteger()) return value(v->getIntValue());
+        if (v->isFloat()) return value(v->getFloatValue());
+        if (v->isBool()) return value(v->getBool());
+        return value(nullptr);
+    }
+    if (auto arr = json->to<JsonArray>()) {
+        bool isSmall = true;
+        for (auto e : *arr) {
+            if (e != nullptr && !e->is<JsonValue>()) isSmall = false;
+        }
+        beginArray(isSmall);
+        for (auto e : *arr) value(e);
+        return endArray();
+    }
+    if (auto obj = json->to<JsonObject>()) {
+        beginObject();
+        for (auto &it : *obj) {
+            key(it.first.string_view());
+            value(it.second);
+        }
+        return endObject();
+    }
+    throw std::logic_error("Unexpected json node");
+}
+
 }  // namespace P4::Util
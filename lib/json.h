@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -204,6 +206,90 @@ class JsonObject final : public IJson, public string_map<IJson *> {
     DECLARE_TYPEINFO(JsonObject, IJson);
 };
 
+/// Writes JSON text incrementally, SAX-style, so that large documents can be
+/// produced without first building a tree of IJson objects.  Existing trees
+/// can be embedded with value(const IJson *).
+///
+/// In the Pretty style the output of value(const IJson *) is identical to
+/// IJson::serialize; arrays opened with beginArray() are laid out one element
+/// per line unless @p inlineValues is set.  The Compact style emits no
+/// whitespace at all.  Output is accumulated in an internal buffer and written
+/// to the stream in large chunks; it is flushed by flush() and on destruction.
+class JsonWriter {
+ public:
+    enum class Style { Pretty, Compact };
+
+    explicit JsonWriter(std::ostream &out, Style style = Style::Pretty)
+        : out(out), style(style) {}
+    ~JsonWriter() { flush(); }
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter &operator=(const JsonWriter &) = delete;
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray(bool inlineValues = false);
+    JsonWriter &endArray();
+    /// Starts a member of the enclosing object; must be followed by a value.
+    JsonWriter &key(std::string_view label);
+
+    JsonWriter &value(std::string_view s);
+    JsonWriter &value(const char *s) { return value(std::string_view(s)); }
+    JsonWriter &value(cstring s) { return value(s.string_view()); }
+    JsonWriter &value(const std::string &s) { return value(std::string_view(s)); }
+    JsonWriter &value(bool b);
+    JsonWriter &value(std::nullptr_t);
+    JsonWriter &value(double v);
+    JsonWriter &value(const big_int &v);
+    template <typename T,
+              typename std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    JsonWriter &value(T v) {
+        beginValue();
+        appendInteger(static_cast<std::conditional_t<std::is_signed_v<T>, long long,
+                                                     unsigned long long>>(v));
+        return *this;
+    }
+    /// Writes a whole tree; null pointers are written as null.
+    JsonWriter &value(const IJson *json);
+
+    /// Shorthand for key(label).value(v).
+    template <typename T>
+    JsonWriter &member(std::string_view label, T &&v) {
+        key(label);
+        return value(std::forward<T>(v));
+    }
+
+    /// Writes the buffered output to the stream.
+    void flush();
+
+ private:
+    struct Scope {
+        bool isObject;
+        bool isInline;
+        bool empty = true;
+    };
+
+    std::ostream &out;
+    Style style;
+    std::string buffer;
+    std::vector<Scope> scopes;
+    /// Current indentation level in the Pretty style.
+    int depth = 0;
+    /// Set between key() and the member value.
+    bool afterKey = false;
+
+    bool pretty() const { return style == Style::Pretty; }
+    void newline();
+    void beginValue();
+    void appendInteger(long long v);
+    void appendInteger(unsigned long long v);
+    void appendString(std::string_view s);
+    void maybeFlush() {
+        if (buffer.size() >= bufferSize) flush();
+    }
+
+    static constexpr size_t bufferSize = 1 << 16;
+};
+
 }  // namespace P4::Util
 
 #endif /* LIB_JSON_H_ */
@@ -43,6 +43,7 @@ namespace Detail {
 
 int verbosity = 0;
 int maximumLogLevel = 0;
+int logLevelGeneration = 1;
 bool enableLoggingGlobally = true;
 bool enableLoggingInContext = false;
 
@@ -293,11 +294,22 @@ std::ostream &fileLogOutput(const char *file) {
     return *info->out;
 }
 
+int CallSiteLogLevel::update(const char *file) {
+    // The generation is read first, so that the level is computed again if the log levels
+    // change meanwhile.
+    int generation = logLevelGeneration;
+    int level = fileLogLevel(file);
+    cached.store(static_cast<uint64_t>(generation) << 32 | static_cast<uint32_t>(level),
+                 std::memory_order_relaxed);
+    return level;
+}
+
 void invalidateCaches(int possibleNewMaxLogLevel) {
     mostRecentFile = nullptr;
     mostRecentInfo = nullptr;
     logLevelCache.clear();
     maximumLogLevel = std::max(maximumLogLevel, possibleNewMaxLogLevel);
+    ++logLevelGeneration;
     for (auto fn : invalidateCallbacks) fn();
 }
 
@@ -341,6 +353,16 @@ void addDebugSpec(const char *spec) {
     Detail::invalidateCaches(maxLogLevelInSpec);
 }
 
+std::vector<std::string> getDebugSpecs() { return Detail::debugSpecs; }
+
+void setDebugSpecs(const std::vector<std::string> &specs) {
+    // The maximum log level is computed again, as it may decrease.
+    Detail::debugSpecs.clear();
+    Detail::maximumLogLevel = 0;
+    Detail::invalidateCaches(Detail::verbosity - 1);
+    for (auto &spec : specs) addDebugSpec(spec.c_str());
+}
+
 void increaseVerbosity() {
 #ifdef MULTITHREAD
     static std::mutex lock;
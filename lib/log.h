@@ -17,10 +17,14 @@ limitations under the License.
 #ifndef LIB_LOG_H_
 #define LIB_LOG_H_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "config.h"
@@ -40,6 +44,10 @@ extern int verbosity;
 // A cache of the maximum log level requested for any file.
 extern int maximumLogLevel;
 
+// Incremented whenever the log levels change, to invalidate the levels cached by the
+// CallSiteLogLevels.
+extern int logLevelGeneration;
+
 // Used to restrict logging to a specific IR context.
 extern bool enableLoggingGlobally;
 extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this is ignored.
@@ -67,6 +75,23 @@ class OutputLogPrefix {
     static void indent(std::ostream &out);
 };
 
+// The log level of the file of a LOGGING call site, cached in a static variable at the call
+// site, so that checking it is a load and a compare until the log levels change.
+class CallSiteLogLevel {
+    // The generation in the upper half and the level in the lower half, so that they are
+    // read and written together. The generations start at 1.
+    std::atomic<uint64_t> cached{0};
+    int update(const char *file);
+
+ public:
+    int get(const char *file) {
+        uint64_t value = cached.load(std::memory_order_relaxed);
+        if (static_cast<int>(value >> 32) == logLevelGeneration)
+            return static_cast<int32_t>(value);
+        return update(file);
+    }
+};
+
 void addInvalidateCallback(void (*)(void));
 std::ostream &clearPrefix(std::ostream &out);
 }  // namespace Detail
@@ -92,6 +117,10 @@ inline bool fileLogLevelIsAtLeast(const char *file, int level) {
 
 // Process @spec and update the log level requested for the appropriate file.
 void addDebugSpec(const char *spec);
+// The specs added so far, e.g. to restore them later with setDebugSpecs.
+std::vector<std::string> getDebugSpecs();
+// Replace all the specs with @specs.
+void setDebugSpecs(const std::vector<std::string> &specs);
 
 inline bool verbose() { return Detail::verbosity > 0; }
 inline int verbosity() { return Detail::verbosity; }
@@ -108,10 +137,73 @@ void increaseVerbosity();
 #define MAX_LOGGING_LEVEL 10
 #endif
 
+// Each of these can be set in config.h (see MAX_LOGGING_LEVEL_<NAME> in CMakeLists.txt) to
+// disable higher logging levels at compile time in one part of the compiler only
+#ifndef MAX_LOGGING_LEVEL_FRONTEND
+#define MAX_LOGGING_LEVEL_FRONTEND MAX_LOGGING_LEVEL
+#endif
+#ifndef MAX_LOGGING_LEVEL_MIDEND
+#define MAX_LOGGING_LEVEL_MIDEND MAX_LOGGING_LEVEL
+#endif
+#ifndef MAX_LOGGING_LEVEL_IR
+#define MAX_LOGGING_LEVEL_IR MAX_LOGGING_LEVEL
+#endif
+#ifndef MAX_LOGGING_LEVEL_TOFINO
+#define MAX_LOGGING_LEVEL_TOFINO MAX_LOGGING_LEVEL
+#endif
+#ifndef P4C_SOURCE_DIR
+#define P4C_SOURCE_DIR ""
+#endif
+#ifndef P4C_BINARY_DIR
+#define P4C_BINARY_DIR ""
+#endif
+
+namespace P4::Log::Detail {
+// The maximum logging level of the part of the compiler that @file is in, found from its
+// first directory relative to the source or build directory.  It only depends on the path of
+// the file containing the log statement, so that inline functions of a header are compiled the
+// same way in every library that includes it.
+consteval int subsystemMaxLoggingLevel(std::string_view file) {
+    struct Subsystem {
+        std::string_view dir;
+        int level;
+    };
+    const Subsystem subsystems[] = {{"frontends/", MAX_LOGGING_LEVEL_FRONTEND},
+                                    {"midend/", MAX_LOGGING_LEVEL_MIDEND},
+                                    {"ir/", MAX_LOGGING_LEVEL_IR},
+                                    {"backends/tofino/", MAX_LOGGING_LEVEL_TOFINO}};
+    // The build directory is often inside the source directory, so the longest one is stripped.
+    size_t root = 0;
+    for (std::string_view dir : {P4C_SOURCE_DIR, P4C_BINARY_DIR})
+        if (file.starts_with(dir) && dir.size() > root) root = dir.size();
+    file.remove_prefix(root);
+    int level = MAX_LOGGING_LEVEL;
+    for (const auto &subsystem : subsystems) {
+        if (file.starts_with(subsystem.dir)) {
+            level = subsystem.level;
+            break;
+        }
+    }
+    return level < MAX_LOGGING_LEVEL ? level : MAX_LOGGING_LEVEL;
+}
+}  // namespace P4::Log::Detail
+
 // NOLINTBEGIN(bugprone-macro-parentheses)
-#define LOGGING_FEATURE(TAG, N) \
-    ((N) <= MAX_LOGGING_LEVEL && P4::Log::fileLogLevelIsAtLeast(TAG, N) && P4::Log::enableLogging())
-#define LOGGING(N) LOGGING_FEATURE(__FILE__, N)
+#define LOGGING_FEATURE(TAG, N)                                                              \
+    ((N) <= P4::Log::Detail::subsystemMaxLoggingLevel(__FILE__) &&                          \
+     P4::Log::fileLogLevelIsAtLeast(TAG, N) && P4::Log::enableLogging())
+// A static CallSiteLogLevel, which is different for each use of the macro.
+#define LOG_CALL_SITE_LEVEL                                     \
+    ([]() -> P4::Log::Detail::CallSiteLogLevel & {              \
+        static P4::Log::Detail::CallSiteLogLevel callSiteLevel; \
+        return callSiteLevel;                                   \
+    }())
+// The tag of LOGGING is the same for every call, so the log level is cached at the call site
+// instead of being looked up by file name.
+#define LOGGING(N)                                                                          \
+    ((N) <= P4::Log::Detail::subsystemMaxLoggingLevel(__FILE__) &&                         \
+     P4::Log::Detail::maximumLogLevel >= (N) && LOG_CALL_SITE_LEVEL.get(__FILE__) >= (N) && \
+     P4::Log::enableLogging())
 
 #define LOGN(N, X)                                                          \
     (LOGGING(N) ? P4::Log::Detail::fileLogOutput(__FILE__)                  \
@@ -71,6 +71,18 @@ static constexpr unsigned kDiscriminatorBits = 56;
 static constexpr uint64_t kInnerTypeIdMask = (UINT64_C(1) << kDiscriminatorBits) - 1;
 static constexpr uint64_t kHashDiscriminator = UINT64_C(0xFF);
 
+/// Interval [first, last] of explicitly-specified typeids. When the typeids of the classes
+/// of a single-inheritance tree are assigned in preorder, the typeids of a class and of all
+/// its descendants in the tree form such an interval.
+struct TypeIdInterval {
+    TypeId first;
+    TypeId last;
+
+    [[nodiscard]] constexpr bool contains(TypeId id) const noexcept {
+        return id >= first && id <= last;
+    }
+};
+
 namespace detail {
 // Apparently string_view does not optimize properly in constexpr context
 // for GCC < 13
@@ -147,6 +159,26 @@ struct TypeIdResolver<T, std::void_t<decltype(T::static_typeId)>> {
     }
 };
 
+// Classes of a single-inheritance tree could implement `T::static_typeIdInterval()`, the
+// interval of typeids of `T` and of its descendants in the tree, and `T::static_typeIdTree()`,
+// the interval of typeids of all classes of the tree. Then is<T> / to<T> on an object of a
+// class of the tree is decided by a range check. Objects with a typeid outside of the tree
+// (e.g. Vector<T> or classes with hash-derived typeids) and other base classes of the tree
+// (e.g. interfaces with multiple inheritance) still use the full hierarchy traversal.
+// The interval is only used if it starts at the typeid of `T`, so that it is ignored when
+// it is inherited from a base class.
+template <typename T, typename = void>
+struct TypeIdIntervalResolver {
+    static constexpr bool exists = false;
+};
+
+template <typename T>
+struct TypeIdIntervalResolver<T, std::void_t<decltype(T::static_typeIdInterval)>> {
+    static constexpr TypeIdInterval interval = T::static_typeIdInterval();
+    static constexpr TypeIdInterval tree = T::static_typeIdTree();
+    static constexpr bool exists = interval.first == TypeIdResolver<T>::resolve();
+};
+
 }  // namespace detail
 
 /// Given a "full" typeid, returns one with discriminator removed
@@ -214,6 +246,11 @@ struct Base {
     /// Same as `isA`, but typeid to check with is derived from template argument.
     template <typename T>
     [[nodiscard]] bool is() const noexcept {
+        using Interval = detail::TypeIdIntervalResolver<std::remove_cv_t<T>>;
+        if constexpr (Interval::exists) {
+            TypeId id = typeId();
+            if (Interval::tree.contains(id)) return Interval::interval.contains(id);
+        }
         return isA(TypeInfo<T>::id());
     }
 
@@ -224,17 +261,31 @@ struct Base {
     /// among its base classes), casted pointer to object of T* type otherwise.
     template <typename T>
     [[nodiscard]] T *to() noexcept {
+        if (outsideInterval<T>()) return nullptr;
         return reinterpret_cast<T *>(const_cast<void *>(toImpl(TypeInfo<T>::id())));
     }
 
     /// Same as `to`, but returns const pointer to T.
     template <typename T>
     [[nodiscard]] const T *to() const noexcept {
+        if (outsideInterval<T>()) return nullptr;
         return reinterpret_cast<const T *>(toImpl(TypeInfo<T>::id()));
     }
 
  protected:
     [[nodiscard]] virtual const void *toImpl(TypeId typeId) const noexcept = 0;
+
+ private:
+    /// Checks if the typeid interval of `T` tells that the object is not a `T`.
+    template <typename T>
+    [[nodiscard]] bool outsideInterval() const noexcept {
+        using Interval = detail::TypeIdIntervalResolver<std::remove_cv_t<T>>;
+        if constexpr (Interval::exists) {
+            TypeId id = typeId();
+            return Interval::tree.contains(id) && !Interval::interval.contains(id);
+        }
+        return false;
+    }
 };
 
 }  // namespace P4::RTTI
@@ -282,6 +333,19 @@ struct Base {
     static constexpr P4::RTTI::TypeId static_typeId() { return P4::RTTI::TypeId(Id); } \
     DECLARE_TYPEINFO_COMMON(T, ##__VA_ARGS__)
 
+/// Same as DECLARE_TYPEINFO_WITH_TYPEID, but also specifies the typeid interval of `T`:
+/// [Id, Last] contains the typeids of `T` and of all its descendants in the
+/// single-inheritance tree whose typeids are in the interval `Tree`.
+/// Used by ir-generator, which assigns the typeids of IR::Node subclasses in preorder.
+#define DECLARE_TYPEINFO_WITH_TYPEID_INTERVAL(T, Id, Last, Tree, ...)                  \
+ public:                                                                               \
+    static constexpr P4::RTTI::TypeId static_typeId() { return P4::RTTI::TypeId(Id); } \
+    static constexpr P4::RTTI::TypeIdInterval static_typeIdInterval() {                \
+        return {P4::RTTI::TypeId(Id), P4::RTTI::TypeId(Last)};                         \
+    }                                                                                  \
+    static constexpr P4::RTTI::TypeIdInterval static_typeIdTree() { return Tree; }     \
+    DECLARE_TYPEINFO_COMMON(T, ##__VA_ARGS__)
+
 /// Declare typinfo for a given class `T` combining discriminator value and
 /// typeid of `InnerT`.
 ///
@@ -49,7 +49,7 @@ cstring SourcePosition::toString() const {
 //////////////////////////////////////////////////////////////////////////////////////////
 
 SourceInfo::SourceInfo(const InputSources *sources, SourcePosition start, SourcePosition end)
-    : sources(sources), start(start), end(end) {
+    : sources(sources) {
     BUG_CHECK(sources != nullptr, "Invalid InputSources in SourceInfo");
     if (!start.isValid() || !end.isValid()) {
         BUG("Invalid source position in SourceInfo %1%-%2% for %3%", start.toString(),
@@ -57,24 +57,32 @@ SourceInfo::SourceInfo(const InputSources *sources, SourcePosition start, Source
     }
     if (start > end)
         BUG("SourceInfo position start %1% after end %2%", start.toString(), end.toString());
+    this->start = sources->getOffset(start);
+    this->end = sources->getOffset(end);
 }
 
 SourceInfo::SourceInfo(const InputSources *sources, SourcePosition point)
     : SourceInfo(sources, point, point) {}
 
-SourceInfo::SourceInfo(cstring filename, int line, int column, cstring srcBrief) {
-    this->filename = filename;
-    this->line = line;
-    this->column = column;
-    this->srcBrief = srcBrief;
+SourceInfo::SourceInfo(cstring filename, int line, int column, cstring srcBrief)
+    : json(new JsonSourceInfo{filename, line, column, srcBrief}) {}
+
+SourcePosition SourceInfo::getStart() const {
+    if (!isValid()) return SourcePosition();
+    return sources->getPosition(start);
+}
+
+SourcePosition SourceInfo::getEnd() const {
+    if (!isValid()) return SourcePosition();
+    return sources->getPosition(end);
 }
 
 cstring SourceInfo::toString() const {
-    return absl::StrFormat("(%v)-(%v)", start.toString(), end.toString());
+    return absl::StrFormat("(%v)-(%v)", getStart().toString(), getEnd().toString());
 }
 
 std::ostream &operator<<(std::ostream &os, const SourceInfo &info) {
-    os << absl::StrFormat("(%v)-(%v)", info.start, info.end);
+    os << absl::StrFormat("(%v)-(%v)", info.getStart(), info.getEnd());
     return os;
 }
 
@@ -82,17 +90,29 @@ std::ostream &operator<<(std::ostream &os, const SourceInfo &info) {
 
 InputSources::InputSources() : sealed(false) {
     mapLine("", 1);  // the first line read will be line 1 of stdin
-    contents.push_back("");
+    lineStarts.push_back(0);
 }
 
-void InputSources::addComment(SourceInfo srcInfo, bool singleLine, cstring body) {
-    if (!singleLine)
-        // Drop the "*/"
-        body = body.exceptLast(2);
-    comments.push_back(new Comment(srcInfo, singleLine, body));
+void InputSources::addComment(SourceInfo srcInfo, bool singleLine) {
+    BUG_CHECK(srcInfo.sources == this, "Comment from other InputSources");
+    commentRanges.emplace_back(srcInfo, singleLine);
 }
 
-const std::vector<Comment *> &InputSources::getAllComments() const { return comments; }
+const std::vector<Comment *> &InputSources::getAllComments() const {
+    for (size_t i = comments.size(); i < commentRanges.size(); i++) {
+        const auto &[srcInfo, singleLine] = commentRanges[i];
+        std::string_view body(contents);
+        body = body.substr(srcInfo.start, srcInfo.end - srcInfo.start);
+        if (singleLine)
+            // Drop the "//"
+            body.remove_prefix(2);
+        else
+            // Drop the "*/"
+            body.remove_suffix(2);
+        comments.push_back(new Comment(srcInfo, singleLine, cstring(body)));
+    }
+    return comments;
+}
 
 /// prevent further changes
 void InputSources::seal() {
@@ -102,8 +122,8 @@ void InputSources::seal() {
 }
 
 unsigned InputSources::lineCount() const {
-    int size = contents.size();
-    if (contents.back().empty()) {
+    int size = lineStarts.size();
+    if (lineStarts.back() == contents.size()) {
         // do not count the last line if it is empty.
         size -= 1;
         if (size < 0) BUG("Negative line count");
@@ -119,14 +139,16 @@ void InputSources::appendToLastLine(std::string_view text) {
         char c = text[i];
         if (c == '\n') BUG("Text contains newlines");
     }
-    contents.back() += text;
+    contents += text;
+    BUG_CHECK(contents.size() <= UINT32_MAX, "Input sources larger than 4GB");
 }
 
 // Append a newline and start a new line
 void InputSources::appendNewline(std::string_view newline) {
     if (sealed) BUG("Appending to sealed InputSources");
-    contents.back() += newline;
-    contents.push_back("");  // start a new line
+    contents += newline;
+    BUG_CHECK(contents.size() <= UINT32_MAX, "Input sources larger than 4GB");
+    lineStarts.push_back(contents.size());  // start a new line
 }
 
 void InputSources::appendText(const char *text) {
@@ -168,7 +190,27 @@ std::string_view InputSources::getLine(unsigned lineNumber) const {
         // don't throw: this code may be called by exceptions
         // reporting on elements that have no source position
     }
-    return contents.at(lineNumber - 1);
+    BUG_CHECK(lineNumber <= lineStarts.size(), "Line %1% not read yet", lineNumber);
+    uint32_t start = lineStarts[lineNumber - 1];
+    uint32_t end = lineNumber < lineStarts.size() ? lineStarts[lineNumber] : contents.size();
+    return std::string_view(contents).substr(start, end - start);
+}
+
+uint32_t InputSources::getOffset(const SourcePosition &position) const {
+    unsigned line = position.getLineNumber();
+    BUG_CHECK(line > 0 && line <= lineStarts.size(), "Line %1% not read yet", line);
+    uint32_t offset = lineStarts[line - 1] + position.getColumnNumber();
+    uint32_t end = line < lineStarts.size() ? lineStarts[line] : contents.size();
+    BUG_CHECK(offset <= end, "Column of %1% past the end of the line", position.toString());
+    return offset;
+}
+
+SourcePosition InputSources::getPosition(uint32_t offset) const {
+    // The last line that starts at or before offset
+    auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    BUG_CHECK(it != lineStarts.begin(), "Invalid offset %1%", offset);
+    --it;
+    return SourcePosition(it - lineStarts.begin() + 1, offset - *it);
 }
 
 void InputSources::mapLine(std::string_view file, unsigned originalSourceLineNo) {
@@ -198,11 +240,11 @@ SourceFileLine InputSources::getSourceLine(unsigned line) const {
     return SourceFileLine(it->second.fileName, realLine);
 }
 
-unsigned InputSources::getCurrentLineNumber() const { return contents.size(); }
+unsigned InputSources::getCurrentLineNumber() const { return lineStarts.size(); }
 
 SourcePosition InputSources::getCurrentPosition() const {
     unsigned line = getCurrentLineNumber();
-    unsigned column = contents.back().size();
+    unsigned column = contents.size() - lineStarts.back();
     return SourcePosition(line, column);
 }
 
@@ -236,13 +278,15 @@ cstring InputSources::getSourceFragment(const SourceInfo &position, int trimWidt
     constexpr char ELIPSIS[] = "...";
     constexpr int ELIPSIS_W = sizeof(ELIPSIS) - 1;
 
+    SourcePosition startPosition = position.getStart();
+    SourcePosition endPosition = position.getEnd();
     // If the position spans multiple lines, truncate to just the first line
-    if (position.getEnd().getLineNumber() > position.getStart().getLineNumber())
-        return getSourceFragment(position.getStart(), trimWidth, useMarker);
+    if (endPosition.getLineNumber() > startPosition.getLineNumber())
+        return getSourceFragment(startPosition, trimWidth, useMarker);
 
-    std::string_view result = getLine(position.getStart().getLineNumber());
-    unsigned int start = position.getStart().getColumnNumber();
-    unsigned int end = position.getEnd().getColumnNumber();
+    std::string_view result = getLine(startPosition.getLineNumber());
+    unsigned int start = startPosition.getColumnNumber();
+    unsigned int end = endPosition.getColumnNumber();
     if (trimWidth == -1) {
         if (!useMarker)
             trimWidth = 0;
@@ -290,13 +334,15 @@ cstring InputSources::getSourceFragment(const SourceInfo &position, int trimWidt
 cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
     if (!position.isValid()) return ""_cs;
 
-    std::string_view result = getLine(position.getStart().getLineNumber());
-    unsigned int start = position.getStart().getColumnNumber();
-    unsigned int end = position.getEnd().getColumnNumber();
+    SourcePosition startPosition = position.getStart();
+    SourcePosition endPosition = position.getEnd();
+    std::string_view result = getLine(startPosition.getLineNumber());
+    unsigned int start = startPosition.getColumnNumber();
+    unsigned int end = endPosition.getColumnNumber();
     bool truncate = false;
 
     // If the position spans multiple lines, truncate to just the first line
-    if (position.getEnd().getLineNumber() > position.getStart().getLineNumber()) {
+    if (endPosition.getLineNumber() > startPosition.getLineNumber()) {
         // go to the end of the first line
         end = result.size();
         if (absl::StrContains(result, "\n")) {
@@ -317,7 +363,7 @@ cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
 
 cstring InputSources::toDebugString() const {
     std::stringstream builder;
-    for (const auto &line : contents) builder << line;
+    builder << contents;
     builder << "---------------" << std::endl;
     for (const auto &lf : line_file_map)
         builder << lf.first << ": " << lf.second.toString() << std::endl;
@@ -338,36 +384,37 @@ cstring SourceInfo::toBriefSourceFragment() const {
 
 cstring SourceInfo::toPositionString() const {
     if (!isValid()) return ""_cs;
-    SourceFileLine position = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine position = sources->getSourceLine(getStart().getLineNumber());
     return position.toString();
 }
 
 cstring SourceInfo::toSourcePositionData(unsigned *outLineNumber, unsigned *outColumnNumber) const {
-    SourceFileLine position = sources->getSourceLine(start.getLineNumber());
+    SourcePosition startPosition = getStart();
+    SourceFileLine position = sources->getSourceLine(startPosition.getLineNumber());
     if (outLineNumber != nullptr) {
         *outLineNumber = position.sourceLine;
     }
     if (outColumnNumber != nullptr) {
-        *outColumnNumber = start.getColumnNumber();
+        *outColumnNumber = startPosition.getColumnNumber();
     }
     return position.fileName;
 }
 
 SourceFileLine SourceInfo::toPosition() const {
-    return sources->getSourceLine(start.getLineNumber());
+    return sources->getSourceLine(getStart().getLineNumber());
 }
 
 SourceFileLine SourceInfo::toPositionEnd() const {
-    return sources->getSourceLine(end.getLineNumber());
+    return sources->getSourceLine(getEnd().getLineNumber());
 }
 
 cstring SourceInfo::getSourceFile() const {
-    auto sourceLine = sources->getSourceLine(start.getLineNumber());
+    auto sourceLine = sources->getSourceLine(getStart().getLineNumber());
     return sourceLine.fileName;
 }
 
 cstring SourceInfo::getLineNum() const {
-    SourceFileLine sourceLine = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine sourceLine = sources->getSourceLine(getStart().getLineNumber());
     return Util::toString(sourceLine.sourceLine);
 }
 
@@ -21,6 +21,8 @@ limitations under the License.
 #ifndef LIB_SOURCE_FILE_H_
 #define LIB_SOURCE_FILE_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
 #include <sstream>
 #include <string_view>
@@ -127,14 +129,22 @@ interpreted relative to some InputSources.
 For a program element, the start is inclusive and the end is
 exclusive (the first position after the language element).
 
+The range is stored as two offsets in the text of the InputSources;
+the line and column numbers are only computed when they are needed,
+e.g., for diagnostics.
+
 SourceInfo can also be "invalid"
 */
 class SourceInfo final {
  public:
-    cstring filename = ""_cs;
-    int line = -1;
-    int column = -1;
-    cstring srcBrief = ""_cs;
+    /// Source position of an IR read with --fromJSON, which has no InputSources.
+    struct JsonSourceInfo {
+        cstring filename = ""_cs;
+        int line = -1;
+        int column = -1;
+        cstring srcBrief = ""_cs;
+    };
+
     SourceInfo(cstring filename, int line, int column, cstring srcBrief);
     /// Creates an "invalid" SourceInfo
     SourceInfo() = default;
@@ -154,21 +164,21 @@ class SourceInfo final {
     SourceInfo operator+(const SourceInfo &rhs) const {
         if (!this->isValid()) return rhs;
         if (!rhs.isValid()) return *this;
-        SourcePosition s = start.min(rhs.start);
-        SourcePosition e = end.max(rhs.end);
-        return SourceInfo(sources, s, e);
+        return SourceInfo(sources, std::min(start, rhs.start), std::max(end, rhs.end));
     }
     SourceInfo &operator+=(const SourceInfo &rhs) {
         if (!isValid()) {
             *this = rhs;
         } else if (rhs.isValid()) {
-            start = start.min(rhs.start);
-            end = end.max(rhs.end);
+            start = std::min(start, rhs.start);
+            end = std::max(end, rhs.end);
         }
         return *this;
     }
 
-    bool operator==(const SourceInfo &rhs) const { return start == rhs.start && end == rhs.end; }
+    bool operator==(const SourceInfo &rhs) const {
+        return isValid() == rhs.isValid() && start == rhs.start && end == rhs.end;
+    }
 
     cstring toString() const;
 
@@ -188,15 +198,18 @@ class SourceInfo final {
     SourceFileLine toPosition() const;
     SourceFileLine toPositionEnd() const;
 
-    bool isValid() const { return this->start.isValid(); }
+    bool isValid() const { return sources != nullptr; }
     explicit operator bool() const { return isValid(); }
 
     cstring getSourceFile() const;
     cstring getLineNum() const;
 
-    const SourcePosition &getStart() const { return this->start; }
+    SourcePosition getStart() const;
 
-    const SourcePosition &getEnd() const { return this->end; }
+    SourcePosition getEnd() const;
+
+    /// The position read with --fromJSON, or nullptr.
+    const JsonSourceInfo *fromJson() const { return json; }
 
     /**
        True if this comes 'before' this source position.
@@ -215,9 +228,15 @@ class SourceInfo final {
     friend std::ostream &operator<<(std::ostream &os, const SourceInfo &info);
 
  private:
+    friend class InputSources;
+    SourceInfo(const InputSources *sources, uint32_t start, uint32_t end)
+        : sources(sources), start(start), end(end) {}
+
     const InputSources *sources = nullptr;
-    SourcePosition start = SourcePosition();
-    SourcePosition end = SourcePosition();
+    const JsonSourceInfo *json = nullptr;
+    /// Offsets in the text of the sources
+    uint32_t start = 0;
+    uint32_t end = 0;
 };
 
 class IHasSourceInfo {
@@ -301,6 +320,11 @@ class InputSources final {
     SourcePosition getCurrentPosition() const;
     unsigned getCurrentLineNumber() const;
 
+    /// Offset in the text of a position; the line of the position must have been read.
+    uint32_t getOffset(const SourcePosition &position) const;
+    /// Line and column of an offset in the text.
+    SourcePosition getPosition(uint32_t offset) const;
+
     /// Prevents further changes; currently not used.
     void seal();
 
@@ -322,7 +346,9 @@ class InputSources final {
     cstring getBriefSourceFragment(const SourceInfo &position) const;
 
     cstring toDebugString() const;
-    void addComment(SourceInfo srcInfo, bool singleLine, cstring body);
+    /// Records a comment read by the lexer: @p srcInfo is the range of its text, with the
+    /// leading "//" of a single-line comment, or the trailing "*/" of a multi-line one.
+    void addComment(SourceInfo srcInfo, bool singleLine);
 
     /// Returns a list of all the comments found in the file, stored as a part of `InputSources`
     const std::vector<Comment *> &getAllComments() const;
@@ -338,10 +364,14 @@ class InputSources final {
 
     std::map<unsigned, SourceFileLine> line_file_map;
 
-    /// Each line also stores the end-of-line character(s)
-    std::vector<std::string> contents;
-    /// The commends found in the file.
-    std::vector<Comment *> comments;
+    /// The text of all the lines, each with its end-of-line character(s)
+    std::string contents;
+    /// Offset in contents of the start of each line, in order
+    std::vector<uint32_t> lineStarts;
+    /// The comments found in the file, with their kind (single-line or not)
+    std::vector<std::pair<SourceInfo, bool>> commentRanges;
+    /// The Comment objects for commentRanges, created when they are requested.
+    mutable std::vector<Comment *> comments;
 };
 
 }  // namespace P4::Util
@@ -17,6 +17,12 @@
 
 #include "checkTableEntries.h"
 
+#include <map>
+#include <string_view>
+#include <unordered_map>
+
+#include "lib/hash.h"
+
 using namespace P4::literals;
 
 /* Given an expression for a entry key , extract the mask and test value.
@@ -46,15 +52,41 @@ void P4::CheckTableEntries::get_mask_val(const IR::Expression *e, big_int &mask,
     }
 }
 
-/* Check two ternary entry keys to see if first one "covers" the second one -- that is, the
- * the first one will always match if the second one does.  That is,  ∀v: v∈k2 -> v∈k1
- */
-bool P4::CheckTableEntries::ternary_covers(const IR::Expression *k1, const IR::Expression *k2) {
-    big_int k1_mask, k1_val, k2_mask, k2_val;
-    get_mask_val(k1, k1_mask, k1_val);
-    get_mask_val(k2, k2_mask, k2_val);
-    if ((k1_mask & k2_mask) != k1_mask) return false;
-    return (k1_val & k1_mask) == (k2_val & k1_mask);
+namespace {
+
+/* Hash of an entry key expression, such that equivalent expressions have the same hash. */
+size_t keyHash(const IR::Expression *e) {
+    if (auto *k = e->to<IR::Constant>()) return Util::Hash()(k->value);
+    if (auto *bl = e->to<IR::BoolLiteral>()) return Util::Hash()(bl->value);
+    size_t rv = Util::Hash()(std::string_view(e->node_type_name()));
+    if (auto *bin = e->to<IR::Operation_Binary>())
+        return Util::Hash()(rv, keyHash(bin->left), keyHash(bin->right));
+    if (auto *un = e->to<IR::Operation_Unary>()) return Util::Hash()(rv, keyHash(un->expr));
+    return rv;
+}
+
+}  // namespace
+
+/* Check whether the ternary keys of entry @prev match every key value that the ternary keys of
+ * @entry match -- that is, the value/mask of @prev "covers" the one of @entry:
+ * ∀v: v∈entry -> v∈prev.  The other key fields of both entries are known to be equivalent. */
+bool P4::CheckTableEntries::covers(const EntryKey &prev, const EntryKey &entry) const {
+    for (size_t i = 0; i < prev.masks.size(); ++i) {
+        if ((prev.masks[i] & entry.masks[i]) != prev.masks[i]) return false;
+        if (prev.vals[i] != (entry.vals[i] & prev.masks[i])) return false;
+    }
+    return true;
+}
+
+/* Extract the masks and masked values of the ternary key fields of @ek */
+void P4::CheckTableEntries::get_masks(EntryKey &ek) {
+    for (unsigned i = 0; i < ek.keys->size(); ++i) {
+        if (!ternary_keys[i]) continue;
+        big_int mask = 0, val = 0;
+        get_mask_val(ek.keys->components[i], mask, val);
+        ek.masks.push_back(mask);
+        ek.vals.push_back(val & mask);
+    }
 }
 
 bool P4::CheckTableEntries::preorder(const IR::P4Table *tbl) {
@@ -62,50 +94,108 @@ bool P4::CheckTableEntries::preorder(const IR::P4Table *tbl) {
     if (!entries || entries->entries.empty()) return false;
     auto *key = tbl->getKey();
     BUG_CHECK(key, "%1% table has entries and no key", tbl);
-    std::vector<bool> ternary_keys;
+    ternary_keys.clear();
     for (auto *key_el : key->keyElements) {
         cstring matchKind = key_el->matchType->path->name.name;
         ternary_keys.push_back(matchKind == "ternary"_cs || matchKind == "optional"_cs);
     }
 
-    // FIXME -- need a way of hashing or ordering ListExpressions so we can use a map
-    // however, need to leave ternary key fields out of that hash/order.  For now we just
-    // look at all of them -- O(n^2) in the number of entries
-    std::vector<const IR::ListExpression *> prev_keys;
+    // Previous entries are put in buckets of entries with equivalent non-ternary key fields,
+    // found by the hash of those fields.  Within a bucket, entries are grouped by the masks of
+    // their ternary key fields, then hashed by their masked ternary values.  An entry can only
+    // be covered by groups whose masks are included in its masks, and there are few distinct
+    // mask combinations in practice, so this is close to linear in the number of entries.
+    // The masks of an entry are only extracted once it is compared with another entry of its
+    // bucket, so entries that are never compared are not checked, as before.
+    struct Bucket {
+        size_t first;  // index in prev_keys of the first entry of the bucket
+        // indexes in prev_keys, by ternary masks then by hash of the masked ternary values
+        std::map<std::vector<big_int>, std::unordered_map<size_t, std::vector<size_t>>> groups;
+    };
+    std::vector<EntryKey> prev_keys;
+    std::unordered_map<size_t, std::vector<Bucket>> buckets;
+    prev_keys.reserve(entries->entries.size());
+
+    auto masked_hash = [](const EntryKey &ek, const std::vector<big_int> &masks) {
+        size_t hash = 0;
+        for (size_t i = 0; i < masks.size(); ++i) hash = Util::Hash()(hash, ek.vals[i] & masks[i]);
+        return hash;
+    };
+    auto add_to_group = [&](Bucket &bucket, size_t index) {
+        auto &ek = prev_keys[index];
+        bucket.groups[ek.masks][masked_hash(ek, ek.masks)].push_back(index);
+    };
 
     for (auto *entry : entries->entries) {
         BUG_CHECK(entry->keys->size() == ternary_keys.size(), "%1% key size mismatch", entry);
+        size_t hash = 0;
+        for (unsigned i = 0; i < entry->keys->size(); ++i)
+            if (!ternary_keys[i]) hash = Util::Hash()(hash, keyHash(entry->keys->components[i]));
 
-        for (auto *prev : prev_keys) {
-            bool no_match = false, ternary_match = false;
-            for (unsigned i = 0; i < entry->keys->size(); ++i) {
-                if (entry->keys->components[i]->equiv(*prev->components[i])) {
-                    // matches
-                } else if (ternary_keys[i]) {
-                    ternary_match = true;
-                    if (!ternary_covers(prev->components[i], entry->keys->components[i])) {
-                        no_match = true;
-                        break;
-                    }
-                } else {
-                    no_match = true;
+        Bucket *bucket = nullptr;
+        auto &hash_buckets = buckets[hash];
+        for (auto &b : hash_buckets) {
+            auto &first_keys = prev_keys[b.first].keys->components;
+            bool same = true;
+            for (unsigned i = 0; i < entry->keys->size() && same; ++i)
+                same = ternary_keys[i] || entry->keys->components[i]->equiv(*first_keys[i]);
+            if (same) {
+                bucket = &b;
+                break;
+            }
+        }
+
+        size_t index = prev_keys.size();
+        prev_keys.push_back(EntryKey{entry->keys, {}, {}});
+        if (!bucket) {
+            hash_buckets.push_back(Bucket{index, {}});
+            continue;
+        }
+        if (bucket->groups.empty()) {
+            get_masks(prev_keys[bucket->first]);
+            add_to_group(*bucket, bucket->first);
+        }
+        auto &ek = prev_keys[index];
+        get_masks(ek);
+
+        const EntryKey *prev = nullptr;
+        size_t prev_index = index;
+        for (auto &[masks, group] : bucket->groups) {
+            bool candidate = true;
+            for (size_t i = 0; i < masks.size() && candidate; ++i)
+                candidate = (masks[i] & ek.masks[i]) == masks[i];
+            if (!candidate) continue;
+            auto it = group.find(masked_hash(ek, masks));
+            if (it == group.end()) continue;
+            // the first previous entry that matches is reported
+            for (size_t i : it->second) {
+                if (i >= prev_index) break;
+                if (covers(prev_keys[i], ek)) {
+                    prev = &prev_keys[i];
+                    prev_index = i;
                     break;
                 }
             }
-            if (no_match) continue;
+        }
+
+        if (prev) {
+            bool ternary_match = false;
+            for (unsigned i = 0; i < entry->keys->size(); ++i)
+                if (ternary_keys[i] &&
+                    !entry->keys->components[i]->equiv(*prev->keys->components[i]))
+                    ternary_match = true;
             if (ternary_match)
                 warning(ErrorType::WARN_TABLE_KEYS, "%1%%2%Ternary entry covered by previous entry",
-                        entry->keys->srcInfo, prev->srcInfo);
+                        entry->keys->srcInfo, prev->keys->srcInfo);
             else if (genError)
                 error(ErrorType::ERR_TABLE_KEYS, "%1%%2%Duplicate entry keys", entry->keys->srcInfo,
-                      prev->srcInfo);
+                      prev->keys->srcInfo);
             else
                 warning(ErrorType::WARN_TABLE_KEYS, "%1%%2%Duplicate entry keys",
-                        entry->keys->srcInfo, prev->srcInfo);
-            // don't bother with more than one error/warning per entry
-            break;
+                        entry->keys->srcInfo, prev->keys->srcInfo);
         }
-        prev_keys.push_back(entry->keys);
+
+        add_to_group(*bucket, index);
     }
     return false;
 }
@@ -18,6 +18,8 @@
 #ifndef MIDEND_CHECKTABLEENTRIES_H_
 #define MIDEND_CHECKTABLEENTRIES_H_
 
+#include <vector>
+
 #include "ir/ir.h"
 #include "ir/visitor.h"
 
@@ -25,11 +27,21 @@ namespace P4 {
 
 class CheckTableEntries : public Inspector {
     bool genError;  // if true, generate errors for duplicates rather than just warnings
+    std::vector<bool> ternary_keys;  // for each key field of the current table
+
+    /// Keys of an entry, with the masks and masked values of its ternary key fields, which are
+    /// only extracted once the entry is compared with another one.
+    struct EntryKey {
+        const IR::ListExpression *keys;
+        std::vector<big_int> masks, vals;
+    };
+
     bool preorder(const IR::P4Table *);
     bool preorder(const IR::P4Parser *) { return false; }
     bool preorder(const IR::Statement *) { return false; }
     void get_mask_val(const IR::Expression *, big_int &mask, big_int &val);
-    bool ternary_covers(const IR::Expression *k1, const IR::Expression *k2);
+    void get_masks(EntryKey &);
+    bool covers(const EntryKey &prev, const EntryKey &entry) const;
 
  public:
     explicit CheckTableEntries(bool err = false) : genError(err) {}
@@ -10,7 +10,8 @@
 namespace P4 {
 
 const IR::Node *FillEnumMap::preorder(IR::Type_Enum *type) {
-    if (type->srcInfo.filename.find("v1model") == nullptr) {
+    auto *loaded = type->srcInfo.fromJson();
+    if (loaded == nullptr || loaded->filename.find("v1model") == nullptr) {
         unsigned long long count = type->members.size();
         unsigned long long width = policy->enumSize(count);
         auto r = new EnumRepresentation(type->srcInfo, width);
@@ -0,0 +1,649 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "mergeTables.h"
+
+#include "frontends/p4/coreLibrary.h"
+#include "lib/big_int_util.h"
+
+namespace P4 {
+
+namespace {
+
+/// Replaces the parameters of an action by constant arguments. As in
+/// SubstituteParameters, all path expressions are cloned, so that the result
+/// can be used as the body of another action.
+class SubstituteArguments : public Transform {
+    const std::map<cstring, const IR::Expression *> &arguments;
+
+ public:
+    explicit SubstituteArguments(const std::map<cstring, const IR::Expression *> &arguments)
+        : arguments(arguments) {
+        setName("SubstituteArguments");
+    }
+
+    const IR::Node *postorder(IR::PathExpression *expression) override {
+        auto it = arguments.find(expression->path->name);
+        if (it != arguments.end()) return it->second->clone();
+        return new IR::PathExpression(
+            new IR::Path(expression->path->name, expression->path->absolute));
+    }
+};
+
+/// @returns the name of the storage accessed by @p expression, e.g. "h.a.b",
+/// or an empty string if it is not a left-value. @p whole is set to false if
+/// only a part of the named storage is accessed.
+cstring storageName(const IR::Expression *expression, bool &whole) {
+    if (expression->is<IR::PathExpression>()) return expression->toString();
+    if (auto member = expression->to<IR::Member>()) {
+        auto base = storageName(member->expr, whole);
+        if (base.isNullOrEmpty() || !whole) return base;
+        return base + "." + member->member.name;
+    }
+    if (auto index = expression->to<IR::ArrayIndex>()) {
+        auto base = storageName(index->left, whole);
+        if (base.isNullOrEmpty() || !whole) return base;
+        if (auto k = index->right->to<IR::Constant>()) return base + "[" + k->toString() + "]";
+        whole = false;
+        return base;
+    }
+    if (auto slice = expression->to<IR::AbstractSlice>()) {
+        auto base = storageName(slice->e0, whole);
+        whole = false;
+        return base;
+    }
+    return cstring::empty;
+}
+
+/// @returns true if the storage named @p a and @p b may overlap. An empty
+/// name stands for any storage.
+bool overlaps(cstring a, cstring b) {
+    if (a.isNullOrEmpty() || b.isNullOrEmpty() || a == b) return true;
+    auto contains = [](std::string_view outer, std::string_view inner) {
+        return inner.size() > outer.size() && inner.substr(0, outer.size()) == outer &&
+               (inner[outer.size()] == '.' || inner[outer.size()] == '[');
+    };
+    return contains(a.string_view(), b.string_view()) || contains(b.string_view(), a.string_view());
+}
+
+bool isConstantValue(const IR::Expression *expression) {
+    return expression->is<IR::Constant>() || expression->is<IR::BoolLiteral>();
+}
+
+/// @returns the bits of the constant @p expression stored in a field of
+/// @p width bits.
+big_int bitsOf(const IR::Expression *expression, int width) {
+    if (auto b = expression->to<IR::BoolLiteral>()) return b->value ? 1 : 0;
+    big_int modulus = Util::shift_left(1, width);
+    big_int value = expression->to<IR::Constant>()->value % modulus;
+    if (value < 0) value += modulus;
+    return value;
+}
+
+using Writes = std::map<cstring, const IR::Expression *>;
+
+/// Records in @p writes the storage written by the calls in @p node. The
+/// arguments of the calls are assumed to be written, except for setValid and
+/// setInvalid, whose effect is known if @p straight.
+void recordCallWrites(const IR::Node *node, bool straight, Writes &writes) {
+    forAllMatching<IR::MethodCallExpression>(node, [&](const IR::MethodCallExpression *mce) {
+        if (auto member = mce->method->to<IR::Member>()) {
+            bool whole = true;
+            auto name = storageName(member->expr, whole);
+            if ((member->member == IR::Type_Header::setValid ||
+                 member->member == IR::Type_Header::setInvalid) &&
+                whole && !name.isNullOrEmpty()) {
+                const IR::Expression *value = nullptr;
+                if (straight)
+                    value = new IR::BoolLiteral(member->member == IR::Type_Header::setValid);
+                writes[name + "." + IR::Type_Header::isValid + "()"] = value;
+                return;
+            }
+            if (!name.isNullOrEmpty()) writes[name] = nullptr;
+        }
+        for (auto argument : *mce->arguments) {
+            bool whole = true;
+            auto name = storageName(argument->expression, whole);
+            if (!name.isNullOrEmpty()) writes[name] = nullptr;
+        }
+    });
+}
+
+/// Records in @p writes the storage written by @p stat. The values written
+/// are only known for statements executed unconditionally, i.e. if
+/// @p straight.
+void recordWrites(const IR::StatOrDecl *stat, bool straight, Writes &writes) {
+    if (auto block = stat->to<IR::BlockStatement>()) {
+        for (auto component : block->components) recordWrites(component, straight, writes);
+    } else if (auto assign = stat->to<IR::BaseAssignmentStatement>()) {
+        recordCallWrites(assign->right, straight, writes);
+        bool whole = true;
+        auto name = storageName(assign->left, whole);
+        const IR::Expression *value = nullptr;
+        if (straight && whole && assign->is<IR::AssignmentStatement>() &&
+            isConstantValue(assign->right))
+            value = assign->right;
+        writes[name] = value;
+    } else if (stat->is<IR::MethodCallStatement>()) {
+        recordCallWrites(stat, straight, writes);
+    } else if (auto decl = stat->to<IR::Declaration_Variable>()) {
+        if (decl->initializer) recordCallWrites(decl->initializer, straight, writes);
+    } else if (!stat->is<IR::EmptyStatement>() && !stat->is<IR::Declaration>()) {
+        // Conditionals: the values written are not known.
+        forAllMatching<IR::BaseAssignmentStatement>(stat, [&](const IR::BaseAssignmentStatement *s) {
+            recordWrites(s, false, writes);
+        });
+        recordCallWrites(stat, false, writes);
+    }
+}
+
+/// Matches the value @p value of a key field of @p width bits against the
+/// element @p keyset of the key set of an entry. @p prefix is set to the
+/// number of bits compared. @returns false if @p keyset is not a
+/// compile-time constant.
+bool matchKeySet(const IR::Expression *keyset, const big_int &value, int width, bool &matches,
+                 unsigned &prefix) {
+    prefix = width;
+    if (keyset->is<IR::DefaultExpression>()) {
+        matches = true;
+        prefix = 0;
+    } else if (isConstantValue(keyset)) {
+        matches = bitsOf(keyset, width) == value;
+    } else if (auto mask = keyset->to<IR::Mask>()) {
+        if (!mask->left->is<IR::Constant>() || !mask->right->is<IR::Constant>()) return false;
+        auto bits = bitsOf(mask->right, width);
+        matches = ((bitsOf(mask->left, width) ^ value) & bits) == 0;
+        prefix = bitcount(bits);
+    } else if (auto range = keyset->to<IR::Range>()) {
+        auto low = range->left->to<IR::Constant>();
+        auto high = range->right->to<IR::Constant>();
+        if (!low || !high) return false;
+        matches = low->value <= value && value <= high->value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool DoMergeTables::keyField(const IR::Expression *expression, KeyField &field) const {
+    auto type = typeMap->getType(expression);
+    if (type == nullptr) return false;
+    if (type->is<IR::Type_Bits>() || type->is<IR::Type_Boolean>())
+        field.width = type->width_bits();
+    else
+        return false;
+    bool whole = true;
+    if (auto mce = expression->to<IR::MethodCallExpression>()) {
+        auto member = mce->method->to<IR::Member>();
+        if (member == nullptr || member->member != IR::Type_Header::isValid ||
+            !mce->arguments->empty())
+            return false;
+        field.name = storageName(member->expr, whole);
+        if (field.name.isNullOrEmpty()) return false;
+        field.name = field.name + "." + IR::Type_Header::isValid + "()";
+    } else {
+        field.name = storageName(expression, whole);
+    }
+    if (field.name.isNullOrEmpty() || !whole) return false;
+    field.expression = expression;
+    field.type = type;
+    return true;
+}
+
+bool DoMergeTables::modelTable(const IR::P4Table *decl, Table &table) const {
+    for (auto property : decl->properties->properties) {
+        auto name = property->name.name;
+        if (name != IR::TableProperties::keyPropertyName &&
+            name != IR::TableProperties::actionsPropertyName &&
+            name != IR::TableProperties::entriesPropertyName &&
+            name != IR::TableProperties::defaultActionPropertyName &&
+            name != IR::TableProperties::sizePropertyName) {
+            LOG2(decl->name << ": not merged because of property " << name);
+            return false;
+        }
+    }
+    auto defaultProperty =
+        decl->properties->getProperty(IR::TableProperties::defaultActionPropertyName);
+    if (defaultProperty == nullptr || !defaultProperty->isConstant) return false;
+    table.defaultAction = decl->getDefaultAction()->to<IR::MethodCallExpression>();
+    if (table.defaultAction == nullptr) return false;
+
+    const auto &corelib = P4CoreLibrary::instance();
+    bool ordered = false;
+    bool lpm = false;
+    if (auto key = decl->getKey()) {
+        for (auto ke : key->keyElements) {
+            KeyField field;
+            if (!keyField(ke->expression, field)) return false;
+            auto kind = ke->matchType->path->name.name;
+            if (kind == corelib.ternaryMatch.name || kind == "range") {
+                // Range bounds are compared as unsigned values.
+                auto bits = field.type->to<IR::Type_Bits>();
+                if (kind == "range" && (bits == nullptr || bits->isSigned)) return false;
+                ordered = true;
+            } else if (kind == corelib.lpmMatch.name) {
+                lpm = true;
+            } else if (kind != corelib.exactMatch.name) {
+                return false;
+            }
+            table.keys.push_back(field);
+            table.matchKinds.push_back(kind);
+        }
+    }
+
+    auto entriesProperty = decl->properties->getProperty(IR::TableProperties::entriesPropertyName);
+    if (entriesProperty != nullptr) {
+        auto entries = decl->getEntries();
+        if (!entriesProperty->isConstant || entries == nullptr) return false;
+        for (auto entry : entries->entries) {
+            if (entry->keys->components.size() != table.keys.size() ||
+                !entry->action->is<IR::MethodCallExpression>())
+                return false;
+            // Entries are modeled as matched in program order; an explicit priority, or the
+            // @priority annotation honoured by BMv2, may select another entry.
+            if (entry->priority != nullptr || entry->hasAnnotation("priority"_cs)) {
+                LOG2(decl->name << ": not merged because " << entry << " has a priority");
+                return false;
+            }
+            table.entries.push_back(entry);
+        }
+    } else if (!table.keys.empty()) {
+        // Entries are added by the control plane.
+        return false;
+    }
+    table.longestPrefix = lpm && !ordered;
+    table.decl = decl;
+    return true;
+}
+
+/// Estimated number of lookups for a packet on a software target: exact keys
+/// take a single hash or array lookup, while ternary, lpm and range keys are
+/// looked up once per distinct mask (tuple space search in DPDK and eBPF,
+/// comparable to the linear scan of BMv2).  A table without a key only runs
+/// its default action.
+unsigned DoMergeTables::lookupCost(const Table &table) {
+    if (table.keys.empty()) return 0;
+    std::set<std::string> masks;
+    for (auto entry : table.entries) {
+        std::string mask;
+        for (size_t i = 0; i < table.keys.size(); i++) {
+            if (table.matchKinds[i] == P4CoreLibrary::instance().exactMatch.name) continue;
+            auto keyset = entry->keys->components.at(i);
+            if (auto m = keyset->to<IR::Mask>())
+                mask += m->right->toString() + ",";
+            else if (keyset->is<IR::DefaultExpression>())
+                mask += "0,";
+            else
+                mask += keyset->toString() + ",";
+        }
+        masks.emplace(mask);
+    }
+    return std::max<unsigned>(1, masks.size());
+}
+
+const DoMergeTables::Call *DoMergeTables::analyzeCall(const IR::MethodCallExpression *mce) {
+    auto path = mce->method->to<IR::PathExpression>();
+    if (path == nullptr) return nullptr;
+    std::string key(path->path->name.name.string_view());
+    for (auto argument : *mce->arguments) key += "," + argument->expression->toString();
+    auto it = calls.find(key);
+    if (it != calls.end()) return &it->second;
+
+    auto decl = declarations.find(path->path->name);
+    if (decl == declarations.end() || !decl->second->is<IR::P4Action>()) return nullptr;
+    Call call;
+    call.action = decl->second->to<IR::P4Action>();
+    const auto &parameters = call.action->parameters->parameters;
+    if (parameters.size() != mce->arguments->size()) return nullptr;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        auto argument = mce->arguments->at(i)->expression;
+        if (parameters.at(i)->direction != IR::Direction::None || !isConstantValue(argument))
+            return nullptr;
+        call.arguments.emplace(parameters.at(i)->name.name, argument);
+    }
+    // The action of the second table must run whenever the first one ends.
+    bool leaves = false;
+    forAllMatching<IR::ReturnStatement>(call.action->body,
+                                        [&](const IR::ReturnStatement *) { leaves = true; });
+    forAllMatching<IR::ExitStatement>(call.action->body,
+                                      [&](const IR::ExitStatement *) { leaves = true; });
+    if (leaves) return nullptr;
+    recordWrites(substitute(&call), true, call.writes);
+    return &calls.emplace(key, call).first->second;
+}
+
+const IR::BlockStatement *DoMergeTables::substitute(const Call *call) const {
+    SubstituteArguments substituteArguments(call->arguments);
+    return call->action->body->apply(substituteArguments)->to<IR::BlockStatement>();
+}
+
+const IR::MethodCallExpression *DoMergeTables::lookup(const Table &table,
+                                                      const std::map<cstring, big_int> &values) {
+    const IR::Entry *best = nullptr;
+    unsigned bestPrefix = 0;
+    for (auto entry : table.entries) {
+        bool matches = true;
+        unsigned prefix = 0;
+        for (size_t i = 0; i < table.keys.size() && matches; i++) {
+            unsigned bits = 0;
+            bool ok = matchKeySet(entry->keys->components.at(i), values.at(table.keys[i].name),
+                                  table.keys[i].width, matches, bits);
+            BUG_CHECK(ok, "%1%: unexpected key set", entry);
+            if (table.matchKinds[i] == P4CoreLibrary::instance().lpmMatch.name) prefix += bits;
+        }
+        if (!matches) continue;
+        if (!table.longestPrefix) return entry->action->to<IR::MethodCallExpression>();
+        if (best == nullptr || prefix > bestPrefix) {
+            best = entry;
+            bestPrefix = prefix;
+        }
+    }
+    if (best != nullptr) return best->action->to<IR::MethodCallExpression>();
+    return table.defaultAction;
+}
+
+const IR::P4Table *DoMergeTables::merge(const IR::P4Table *firstDecl,
+                                        const IR::P4Table *secondDecl) {
+    Table first, second;
+    if (!modelTable(firstDecl, first) || !modelTable(secondDecl, second)) return nullptr;
+    for (auto entry : first.entries) {
+        bool matches;
+        unsigned prefix;
+        for (size_t i = 0; i < first.keys.size(); i++)
+            if (!matchKeySet(entry->keys->components.at(i), 0, first.keys[i].width, matches,
+                             prefix))
+                return nullptr;
+    }
+    for (auto entry : second.entries) {
+        bool matches;
+        unsigned prefix;
+        for (size_t i = 0; i < second.keys.size(); i++)
+            if (!matchKeySet(entry->keys->components.at(i), 0, second.keys[i].width, matches,
+                             prefix))
+                return nullptr;
+    }
+
+    std::vector<const IR::MethodCallExpression *> firstCalls = {first.defaultAction};
+    for (auto entry : first.entries)
+        firstCalls.push_back(entry->action->to<IR::MethodCallExpression>());
+    std::vector<const Call *> firstEffects;
+    for (auto mce : firstCalls) {
+        auto call = analyzeCall(mce);
+        if (call == nullptr) return nullptr;
+        firstEffects.push_back(call);
+    }
+    if (analyzeCall(second.defaultAction) == nullptr) return nullptr;
+    for (auto entry : second.entries)
+        if (analyzeCall(entry->action->to<IR::MethodCallExpression>()) == nullptr) return nullptr;
+
+    // Value of the key field @p field of the second table after @p call:
+    // nullptr if it is not written. @returns false if the value is not known.
+    auto valueAfter = [](const Call *call, const KeyField &field, const IR::Expression *&value) {
+        value = nullptr;
+        for (auto &[name, written] : call->writes) {
+            if (!overlaps(name, field.name)) continue;
+            if (name != field.name || written == nullptr) return false;
+            value = written;
+        }
+        return true;
+    };
+
+    std::vector<KeyField> keys = first.keys;
+    for (auto &field : second.keys) {
+        bool always = true;
+        for (auto call : firstEffects) {
+            const IR::Expression *value;
+            if (!valueAfter(call, field, value)) {
+                LOG2(secondDecl->name << ": key " << field.expression << " is written by "
+                                      << call->action->name);
+                return nullptr;
+            }
+            if (value == nullptr) always = false;
+        }
+        bool known = std::any_of(keys.begin(), keys.end(),
+                                 [&](const KeyField &k) { return k.name == field.name; });
+        if (!always && !known) keys.push_back(field);
+    }
+    unsigned width = 0;
+    for (auto &k : keys) width += k.width;
+    if (width >= 32 || (size_t(1) << width) > maxEntries) {
+        LOG2(firstDecl->name << ", " << secondDecl->name << ": merged key of " << width
+                             << " bits is too large");
+        return nullptr;
+    }
+    // The merged table takes a single exact lookup, or none if it has no key.
+    unsigned cost = lookupCost(first) + lookupCost(second);
+    unsigned mergedCost = keys.empty() ? 0 : 1;
+    if (mergedCost >= cost) {
+        LOG2(firstDecl->name << ", " << secondDecl->name << ": estimated lookups per packet "
+                             << cost << " would not decrease");
+        return nullptr;
+    }
+
+    // Enumerate the values of the merged key.
+    size_t count = size_t(1) << width;
+    std::vector<std::pair<const Call *, const Call *>> fused;
+    std::map<std::pair<const Call *, const Call *>, size_t> fusedIndex;
+    std::vector<size_t> results(count);
+    for (size_t i = 0; i < count; i++) {
+        std::map<cstring, big_int> values;
+        unsigned shift = width;
+        for (auto &k : keys) {
+            shift -= k.width;
+            values[k.name] = (i >> shift) & ((size_t(1) << k.width) - 1);
+        }
+        auto firstCall = analyzeCall(lookup(first, values));
+        for (auto &field : second.keys) {
+            const IR::Expression *value = nullptr;
+            valueAfter(firstCall, field, value);
+            if (value != nullptr) values[field.name] = bitsOf(value, field.width);
+        }
+        auto secondCall = analyzeCall(lookup(second, values));
+        auto pair = std::make_pair(firstCall, secondCall);
+        auto it = fusedIndex.find(pair);
+        if (it == fusedIndex.end()) {
+            it = fusedIndex.emplace(pair, fused.size()).first;
+            fused.push_back(pair);
+        }
+        results[i] = it->second;
+    }
+
+    // The bodies of both actions are put in the same block.
+    for (auto &[firstCall, secondCall] : fused) {
+        std::set<cstring> locals;
+        for (auto stat : firstCall->action->body->components)
+            if (auto decl = stat->to<IR::Declaration>()) locals.emplace(decl->name.name);
+        for (auto stat : secondCall->action->body->components) {
+            auto decl = stat->to<IR::Declaration>();
+            if (decl != nullptr && locals.count(decl->name.name)) return nullptr;
+        }
+    }
+
+    // The most frequent action is the default action.
+    std::vector<size_t> frequency(fused.size());
+    for (auto r : results) frequency[r]++;
+    size_t defaultIndex = std::max_element(frequency.begin(), frequency.end()) - frequency.begin();
+
+    auto hidden = new IR::Annotation(IR::Annotation::hiddenAnnotation, {});
+    std::vector<const IR::Declaration *> decls;
+    std::vector<cstring> actionNames;
+    IR::IndexedVector<IR::ActionListElement> actionList;
+    for (auto &[firstCall, secondCall] : fused) {
+        IR::IndexedVector<IR::StatOrDecl> body;
+        body.append(substitute(firstCall)->components);
+        body.append(substitute(secondCall)->components);
+        cstring name = nameGen.newName(firstCall->action->name.name + "_" +
+                                       secondCall->action->name.name);
+        auto action = new IR::P4Action(firstDecl->srcInfo, name, {hidden},
+                                       new IR::ParameterList(), new IR::BlockStatement(body));
+        decls.push_back(action);
+        declarations.emplace(name, action);
+        actionNames.push_back(name);
+        actionList.push_back(new IR::ActionListElement(
+            new IR::MethodCallExpression(new IR::PathExpression(name))));
+    }
+
+    IR::Vector<IR::Entry> entries;
+    for (size_t i = 0; i < count; i++) {
+        if (results[i] == defaultIndex) continue;
+        IR::Vector<IR::Expression> components;
+        unsigned shift = width;
+        for (auto &k : keys) {
+            shift -= k.width;
+            size_t value = (i >> shift) & ((size_t(1) << k.width) - 1);
+            if (k.type->is<IR::Type_Boolean>())
+                components.push_back(new IR::BoolLiteral(value != 0));
+            else
+                components.push_back(new IR::Constant(k.type, value, 10, true));
+        }
+        entries.push_back(new IR::Entry(
+            false, nullptr, new IR::ListExpression(components),
+            new IR::MethodCallExpression(new IR::PathExpression(actionNames[results[i]])),
+            false));
+    }
+
+    IR::IndexedVector<IR::Property> properties;
+    if (!keys.empty()) {
+        IR::Vector<IR::KeyElement> elements;
+        for (auto &k : keys)
+            elements.push_back(new IR::KeyElement(
+                k.expression, new IR::PathExpression(P4CoreLibrary::instance().exactMatch.Id())));
+        properties.push_back(new IR::Property(IR::ID(IR::TableProperties::keyPropertyName),
+                                              new IR::Key(elements), false));
+    }
+    properties.push_back(new IR::Property(IR::ID(IR::TableProperties::actionsPropertyName),
+                                          new IR::ActionList(actionList), false));
+    properties.push_back(new IR::Property(
+        IR::ID(IR::TableProperties::defaultActionPropertyName),
+        new IR::ExpressionValue(
+            new IR::MethodCallExpression(new IR::PathExpression(actionNames[defaultIndex]))),
+        true));
+    if (!entries.empty()) {
+        auto size = entries.size();
+        properties.push_back(new IR::Property(IR::ID(IR::TableProperties::entriesPropertyName),
+                                              new IR::EntriesList(entries), true));
+        properties.push_back(new IR::Property(IR::ID(IR::TableProperties::sizePropertyName),
+                                              new IR::ExpressionValue(new IR::Constant(size)),
+                                              false));
+    }
+    cstring name = nameGen.newName(firstDecl->name.name + "_" + secondDecl->name.name);
+    auto table = new IR::P4Table(firstDecl->srcInfo, name, {hidden},
+                                 new IR::TableProperties(properties));
+    decls.push_back(table);
+    declarations.emplace(name, table);
+
+    LOG1("Merged tables " << firstDecl->name << " and " << secondDecl->name << " into " << name
+                          << ": " << entries.size() << " entries, " << fused.size()
+                          << " actions, estimated lookups per packet " << cost << " -> "
+                          << mergedCost);
+    slots[name] = std::max(slots.at(firstDecl->name), slots.at(secondDecl->name));
+    for (auto decl : {firstDecl, secondDecl}) {
+        removed.emplace(decl->name);
+        merged.erase(decl->name);
+    }
+    merged.emplace(name, decls);
+    return table;
+}
+
+const IR::P4Table *DoMergeTables::appliedTable(const IR::StatOrDecl *stat) const {
+    auto mcs = stat->to<IR::MethodCallStatement>();
+    if (mcs == nullptr) return nullptr;
+    auto member = mcs->methodCall->method->to<IR::Member>();
+    if (member == nullptr || member->member != IR::IApply::applyMethodName) return nullptr;
+    auto path = member->expr->to<IR::PathExpression>();
+    if (path == nullptr) return nullptr;
+    auto name = path->path->name.name;
+    auto decl = declarations.find(name);
+    if (decl == declarations.end() || !decl->second->is<IR::P4Table>()) return nullptr;
+    // Merged tables are applied once by construction.
+    if (!merged.count(name) && (applies.at(name) != 1 || applyStatements.at(name) != 1))
+        return nullptr;
+    return decl->second->to<IR::P4Table>();
+}
+
+const IR::Node *DoMergeTables::preorder(IR::P4Control *control) {
+    declarations.clear();
+    applies.clear();
+    applyStatements.clear();
+    slots.clear();
+    merged.clear();
+    removed.clear();
+    calls.clear();
+    for (size_t i = 0; i < control->controlLocals.size(); i++) {
+        auto decl = control->controlLocals.at(i);
+        declarations.emplace(decl->name.name, decl);
+        if (decl->is<IR::P4Table>()) {
+            slots.emplace(decl->name.name, i);
+            applies.emplace(decl->name.name, 0);
+            applyStatements.emplace(decl->name.name, 0);
+        }
+    }
+    auto tableName = [&](const IR::MethodCallExpression *mce) -> cstring {
+        auto member = mce->method->to<IR::Member>();
+        if (member == nullptr || member->member != IR::IApply::applyMethodName)
+            return cstring::empty;
+        auto path = member->expr->to<IR::PathExpression>();
+        if (path == nullptr || !applies.count(path->path->name.name)) return cstring::empty;
+        return path->path->name.name;
+    };
+    forAllMatching<IR::MethodCallExpression>(control->body, [&](const IR::MethodCallExpression *m) {
+        auto name = tableName(m);
+        if (!name.isNullOrEmpty()) applies[name]++;
+    });
+    forAllMatching<IR::MethodCallStatement>(control->body, [&](const IR::MethodCallStatement *m) {
+        auto name = tableName(m->methodCall);
+        if (!name.isNullOrEmpty()) applyStatements[name]++;
+    });
+    return control;
+}
+
+const IR::Node *DoMergeTables::postorder(IR::BlockStatement *block) {
+    if (!isInContext<IR::P4Control>()) return block;
+    IR::IndexedVector<IR::StatOrDecl> components;
+    bool changed = false;
+    for (auto stat : block->components) {
+        auto table = appliedTable(stat);
+        if (table != nullptr && !components.empty()) {
+            if (auto previous = appliedTable(components.back())) {
+                if (auto result = merge(previous, table)) {
+                    components.pop_back();
+                    components.push_back(new IR::MethodCallStatement(
+                        stat->srcInfo, new IR::MethodCallExpression(new IR::Member(
+                                           new IR::PathExpression(result->name),
+                                           IR::IApply::applyMethodName))));
+                    changed = true;
+                    continue;
+                }
+            }
+        }
+        components.push_back(stat);
+    }
+    if (changed) block->components = components;
+    return block;
+}
+
+const IR::Node *DoMergeTables::postorder(IR::P4Control *control) {
+    if (merged.empty()) return control;
+    std::map<size_t, std::vector<const IR::Declaration *>> inserted;
+    for (auto &[name, decls] : merged) {
+        auto &at = inserted[slots.at(name)];
+        at.insert(at.end(), decls.begin(), decls.end());
+    }
+    IR::IndexedVector<IR::Declaration> locals;
+    for (size_t i = 0; i < control->controlLocals.size(); i++) {
+        auto decl = control->controlLocals.at(i);
+        if (!removed.count(decl->name.name)) locals.push_back(decl);
+        auto it = inserted.find(i);
+        if (it == inserted.end()) continue;
+        for (auto added : it->second) locals.push_back(added);
+    }
+    control->controlLocals = locals;
+    return control;
+}
+
+}  // namespace P4
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef MIDEND_MERGETABLES_H_
+#define MIDEND_MERGETABLES_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "ir/ir.h"
+#include "lib/ordered_map.h"
+
+namespace P4 {
+
+/**
+Merges tables whose contents are fixed at compile time and which are applied
+back-to-back into a single table, so that software targets do one lookup
+instead of two. A table is fixed if its entries and its default action are
+'const' and it has no other property than key, actions and size. Its entries
+are matched in program order, or by longest prefix for lpm keys without
+ternary or range keys, so tables whose entries have priorities, such as the
+@priority annotation of BMv2, are not merged. The merged table has an exact
+key made of the keys of both tables, which is small enough to be enumerated:
+it is a direct-indexed array. Its actions run the action of the first table
+followed by the one of the second table. Tables are only merged if this
+decreases the estimated number of lookups per packet: one per distinct mask
+of the ternary, lpm and range keys of each table, none for a table without a
+key, and one for the merged table if it has a key.
+
+When the action of the first table writes a key field of the second table
+with a constant, the value written is used for the lookup in the second table,
+and the field is not part of the merged key if every action writes it. The
+merge is not done if an action of the first table may write a key field of
+the second table with any other value.
+
+table t1 {
+    key = { h.a : exact; }
+    actions = { set_m; }
+    const entries = { 1 : set_m(2); }
+    const default_action = set_m(3);
+}
+table t2 {
+    key = { m.x : exact; }
+    actions = { fwd; drop; }
+    const entries = { 2 : fwd(); }
+    const default_action = drop();
+}
+apply {
+    t1.apply();
+    t2.apply();
+}
+
+becomes
+
+@hidden action set_m_fwd() { m.x = 2; ... }
+@hidden action set_m_drop() { m.x = 3; ... }
+@hidden table t1_t2 {
+    key = { h.a : exact; }
+    actions = { set_m_fwd; set_m_drop; }
+    const entries = { 1 : set_m_fwd(); }
+    const default_action = set_m_drop();
+    size = 1;
+}
+apply {
+    t1_t2.apply();
+}
+
+Both tables must be applied exactly once, by statements of their own: the
+hit, miss and action_run results of the original tables are not available.
+The merged tables and their actions are @hidden; since the contents of the
+original tables are fixed, no run-time update is lost. However, backends that
+generate the control plane API (P4Info) before their midend still list the
+original tables, which no longer exist in the generated program. The pass is
+therefore only run with the --merge-tables option.
+ */
+class DoMergeTables : public Transform {
+    /// A field of a table key.
+    struct KeyField {
+        const IR::Expression *expression;
+        /// Storage read by the key, e.g. "h.a" or "h.isValid()".
+        cstring name;
+        const IR::Type *type;
+        int width;
+    };
+
+    /// A table whose contents are fixed at compile time.
+    struct Table {
+        const IR::P4Table *decl;
+        std::vector<KeyField> keys;
+        std::vector<cstring> matchKinds;
+        std::vector<const IR::Entry *> entries;
+        const IR::MethodCallExpression *defaultAction;
+        /// The entry with the longest prefix wins, instead of the first one.
+        bool longestPrefix;
+    };
+
+    /// A call of an action with constant arguments.
+    struct Call {
+        const IR::P4Action *action;
+        std::map<cstring, const IR::Expression *> arguments;
+        /// Storage written by the action, with the constant written, or
+        /// nullptr if the value is not known.
+        std::map<cstring, const IR::Expression *> writes;
+    };
+
+    TypeMap *typeMap;
+    unsigned maxEntries;
+    MinimalNameGenerator nameGen;
+
+    // State of the control being visited.
+    std::map<cstring, const IR::Declaration *> declarations;
+    std::map<cstring, unsigned> applies;
+    std::map<cstring, unsigned> applyStatements;
+    /// Position of each table in the control locals; a merged table takes
+    /// the position of the last of its tables.
+    std::map<cstring, size_t> slots;
+    /// Merged tables, with the actions declared for them.
+    ordered_map<cstring, std::vector<const IR::Declaration *>> merged;
+    std::set<cstring> removed;
+    std::map<cstring, Call> calls;
+
+    bool keyField(const IR::Expression *expression, KeyField &field) const;
+    bool modelTable(const IR::P4Table *decl, Table &table) const;
+    static unsigned lookupCost(const Table &table);
+    const Call *analyzeCall(const IR::MethodCallExpression *mce);
+    const IR::BlockStatement *substitute(const Call *call) const;
+    static const IR::MethodCallExpression *lookup(const Table &table,
+                                                  const std::map<cstring, big_int> &values);
+    const IR::P4Table *appliedTable(const IR::StatOrDecl *stat) const;
+    const IR::P4Table *merge(const IR::P4Table *firstDecl, const IR::P4Table *secondDecl);
+
+ public:
+    DoMergeTables(TypeMap *typeMap, unsigned maxEntries) : typeMap(typeMap), maxEntries(maxEntries) {
+        CHECK_NULL(typeMap);
+        setName("DoMergeTables");
+    }
+
+    Visitor::profile_t init_apply(const IR::Node *node) override {
+        auto rv = Transform::init_apply(node);
+        node->apply(nameGen);
+        return rv;
+    }
+
+    const IR::Node *preorder(IR::P4Parser *parser) override {
+        prune();
+        return parser;
+    }
+    const IR::Node *preorder(IR::Function *function) override {
+        prune();
+        return function;
+    }
+    const IR::Node *preorder(IR::P4Action *action) override {
+        prune();
+        return action;
+    }
+    const IR::Node *preorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::BlockStatement *block) override;
+    const IR::Node *postorder(IR::P4Control *control) override;
+};
+
+/// Optional pass for software targets; see DoMergeTables. @p maxEntries
+/// bounds the number of key values of a merged table.
+class MergeTables : public PassManager {
+ public:
+    explicit MergeTables(TypeMap *typeMap, unsigned maxEntries = 256,
+                         TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(nullptr, typeMap);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoMergeTables(typeMap, maxEntries));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("MergeTables");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_MERGETABLES_H_ */
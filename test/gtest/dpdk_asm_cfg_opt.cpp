@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <sstream>
+#include <string>
+
+#include "backends/dpdk/dpdkAsmCfgOpt.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace P4::Test {
+
+namespace {
+
+/// A bit<32> field of the metadata structure.
+const IR::Member *m(const char *field) {
+    return new IR::Member(new IR::PathExpression(IR::ID("m")), IR::ID(field));
+}
+
+const IR::Constant *c(int value) { return new IR::Constant(IR::Type_Bits::get(32), value); }
+
+/// A program with a single apply block made of @p stmts, and a metadata
+/// structure declaring the bit<32> fields they use.
+const IR::DpdkAsmProgram *program(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts,
+                                  std::initializer_list<const char *> fields) {
+    IR::IndexedVector<IR::StructField> structFields;
+    for (auto f : fields)
+        structFields.push_back(new IR::StructField(IR::ID(f), IR::Type_Bits::get(32)));
+    IR::IndexedVector<IR::DpdkStructType> structs;
+    structs.push_back(new IR::DpdkStructType(
+        Util::SourceInfo(), IR::ID("main_metadata_t"),
+        {new IR::Annotation(IR::ID("__metadata__"), {})}, structFields));
+    IR::IndexedVector<IR::DpdkAsmStatement> statements;
+    statements.push_back(new IR::DpdkListStatement(stmts));
+    return new IR::DpdkAsmProgram({}, structs, {}, {}, {}, {}, {}, {}, statements, {});
+}
+
+/// The instructions of the apply block of @p node, one per line.
+std::string instructions(const IR::Node *node) {
+    auto p = node->to<IR::DpdkAsmProgram>();
+    EXPECT_NE(p, nullptr);
+    std::stringstream out;
+    for (auto s : p->statements) {
+        for (auto stmt : s->checkedTo<IR::DpdkListStatement>()->statements) {
+            stmt->toSpec(out);
+            out << "\n";
+        }
+    }
+    return out.str();
+}
+
+}  // namespace
+
+class DpdkAsmCfgOpt : public P4CTest {};
+
+TEST_F(DpdkAsmCfgOpt, StoreLiveOnOneBranchIsKept) {
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("a"), c(1)),
+            new IR::DpdkJmpEqualStatement("LABEL_1"_cs, m("x"), c(0)),
+            new IR::DpdkMovStatement(m("a"), c(2)),
+            new IR::DpdkLabelStatement("LABEL_1"_cs),
+            new IR::DpdkMovStatement(m("b"), m("a")),
+        },
+        {"a", "b", "x"});
+    auto result = p->apply(DPDK::EliminateDeadStores());
+    EXPECT_EQ(instructions(result),
+              "mov m.a 0x1\n"
+              "jmpeq LABEL_1 m.x 0x0\n"
+              "mov m.a 0x2\n"
+              "LABEL_1 :\n"
+              "mov m.b m.a\n");
+}
+
+TEST_F(DpdkAsmCfgOpt, StoreOverwrittenOnBothBranchesIsRemoved) {
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("a"), c(1)),
+            new IR::DpdkJmpEqualStatement("LABEL_1"_cs, m("x"), c(0)),
+            new IR::DpdkMovStatement(m("a"), c(2)),
+            new IR::DpdkJmpLabelStatement("LABEL_2"_cs),
+            new IR::DpdkLabelStatement("LABEL_1"_cs),
+            new IR::DpdkMovStatement(m("a"), c(3)),
+            new IR::DpdkLabelStatement("LABEL_2"_cs),
+            new IR::DpdkMovStatement(m("b"), m("a")),
+        },
+        {"a", "b", "x"});
+    auto result = p->apply(DPDK::EliminateDeadStores());
+    EXPECT_EQ(instructions(result),
+              "jmpeq LABEL_1 m.x 0x0\n"
+              "mov m.a 0x2\n"
+              "jmp LABEL_2\n"
+              "LABEL_1 :\n"
+              "mov m.a 0x3\n"
+              "LABEL_2 :\n"
+              "mov m.b m.a\n");
+}
+
+TEST_F(DpdkAsmCfgOpt, LivenessAcrossLoopBackEdge) {
+    // m.a is written at the end of the body and read at the start of the next
+    // iteration, so it is kept although it is overwritten after the loop.
+    // m.e = 0x3 is overwritten both at the start of the body and after the loop.
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("a"), c(0)),
+            new IR::DpdkLabelStatement("LABEL_1"_cs),
+            new IR::DpdkMovStatement(m("e"), c(2)),
+            new IR::DpdkMovStatement(m("b"), m("a")),
+            new IR::DpdkMovStatement(m("a"), m("e")),
+            new IR::DpdkMovStatement(m("e"), c(3)),
+            new IR::DpdkJmpNotEqualStatement("LABEL_1"_cs, m("b"), c(0)),
+            new IR::DpdkMovStatement(m("a"), c(1)),
+            new IR::DpdkMovStatement(m("e"), c(4)),
+        },
+        {"a", "b", "e"});
+    auto result = p->apply(DPDK::EliminateDeadStores());
+    EXPECT_EQ(instructions(result),
+              "mov m.a 0x0\n"
+              "LABEL_1 :\n"
+              "mov m.e 0x2\n"
+              "mov m.b m.a\n"
+              "mov m.a m.e\n"
+              "jmpneq LABEL_1 m.b 0x0\n"
+              "mov m.a 0x1\n"
+              "mov m.e 0x4\n");
+}
+
+TEST_F(DpdkAsmCfgOpt, CopyIsNotPropagatedOverTableApply) {
+    // The table may write any field, so the copy is only used before it.
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("a"), m("b")),
+            new IR::DpdkMovStatement(m("c"), m("a")),
+            new IR::DpdkApplyStatement("t"_cs),
+            new IR::DpdkMovStatement(m("d"), m("a")),
+        },
+        {"a", "b", "c", "d"});
+    auto result = p->apply(DPDK::PropagateCopies());
+    EXPECT_EQ(instructions(result),
+              "mov m.a m.b\n"
+              "mov m.c m.b\n"
+              "table t\n"
+              "mov m.d m.a\n");
+}
+
+TEST_F(DpdkAsmCfgOpt, CopyIsPropagatedOnlyWhenAvailableOnEveryPath) {
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("a"), m("b")),
+            new IR::DpdkMovStatement(m("c"), m("b")),
+            new IR::DpdkJmpEqualStatement("LABEL_1"_cs, m("x"), c(0)),
+            new IR::DpdkMovStatement(m("a"), m("e")),
+            new IR::DpdkLabelStatement("LABEL_1"_cs),
+            new IR::DpdkMovStatement(m("d"), m("a")),
+            new IR::DpdkMovStatement(m("f"), m("c")),
+        },
+        {"a", "b", "c", "d", "e", "f", "x"});
+    auto result = p->apply(DPDK::PropagateCopies());
+    EXPECT_EQ(instructions(result),
+              "mov m.a m.b\n"
+              "mov m.c m.b\n"
+              "jmpeq LABEL_1 m.x 0x0\n"
+              "mov m.a m.e\n"
+              "LABEL_1 :\n"
+              "mov m.d m.a\n"
+              "mov m.f m.b\n");
+}
+
+TEST_F(DpdkAsmCfgOpt, CoalescedTemporariesAreChosenByName) {
+    // m.out is used in both blocks, so only m.tmp_a and m.tmp_b are temporaries.
+    // m.tmp_b is defined first, but m.tmp_a is kept since it sorts first.
+    auto p = program(
+        {
+            new IR::DpdkMovStatement(m("tmp_b"), c(1)),
+            new IR::DpdkMovStatement(m("out"), m("tmp_b")),
+            new IR::DpdkLabelStatement("LABEL_1"_cs),
+            new IR::DpdkMovStatement(m("tmp_a"), c(2)),
+            new IR::DpdkMovStatement(m("out"), m("tmp_a")),
+        },
+        {"out", "tmp_a", "tmp_b"});
+    auto result = p->apply(DPDK::CoalesceMetadataTemporaries());
+    EXPECT_EQ(instructions(result),
+              "mov m.tmp_a 0x1\n"
+              "mov m.out m.tmp_a\n"
+              "LABEL_1 :\n"
+              "mov m.tmp_a 0x2\n"
+              "mov m.out m.tmp_a\n");
+}
+
+}  // namespace P4::Test
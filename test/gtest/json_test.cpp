@@ -74,4 +74,46 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonWriter) {
+    auto arr = new JsonArray();
+    arr->append(5);
+    arr->append("5");
+    auto arr1 = new JsonArray();
+    arr1->append(true);
+    arr->append(arr1);
+    auto obj = new JsonObject();
+    obj->emplace("x", "x");
+    obj->emplace("y", arr);
+    obj->emplace("z", new JsonObject());
+
+    std::stringstream pretty;
+    JsonWriter(pretty).value(obj);
+    EXPECT_EQ(obj->toString(), pretty.str());
+
+    std::stringstream compact;
+    JsonWriter(compact, JsonWriter::Style::Compact).value(obj);
+    EXPECT_EQ("{\"x\":\"x\",\"y\":[5,\"5\",[true]],\"z\":{}}", compact.str());
+
+    std::stringstream streamed;
+    {
+        JsonWriter writer(streamed);
+        writer.beginObject();
+        writer.member("a", 1).member("b", 2.5).member("c", nullptr);
+        writer.key("d").beginArray(true).value(big_int(7)).value(false).endArray();
+        writer.key("e").beginArray().value(arr1).endArray();
+        writer.key("f").value(arr);
+        writer.endObject();
+    }
+    EXPECT_EQ(
+        "{\n  \"a\" : 1,\n  \"b\" : 2.5,\n  \"c\" : null,\n  \"d\" : [7, false],\n"
+        "  \"e\" : [\n    [true]\n  ],\n  \"f\" : [\n    5,\n    \"5\",\n    [true]\n  ]\n}",
+        streamed.str());
+
+    std::stringstream unbalanced;
+    JsonWriter writer(unbalanced);
+    writer.beginObject();
+    EXPECT_THROW(writer.value(1), std::logic_error);
+    EXPECT_THROW(writer.endArray(), std::logic_error);
+}
+
 }  // namespace P4::Util
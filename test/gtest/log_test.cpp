@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace P4::Test {
+
+namespace {
+
+/// Always checks the log level at the same LOGGING call site.
+bool logging(int level) { return LOGGING(level); }
+
+}  // namespace
+
+/// Restores the debug specs after each test, so that they do not leak into other tests.
+class LogLevels : public ::testing::Test {
+    std::vector<std::string> specs;
+
+ protected:
+    void SetUp() override { specs = Log::getDebugSpecs(); }
+    void TearDown() override { Log::setDebugSpecs(specs); }
+};
+
+TEST_F(LogLevels, CallSiteLevels) {
+    EXPECT_FALSE(logging(1));
+    EXPECT_FALSE(LOGGING(1));
+
+    // The levels cached at the call sites are updated when the specs change.
+    Log::addDebugSpec("log_test:2");
+    EXPECT_TRUE(logging(1));
+    EXPECT_TRUE(logging(2));
+    EXPECT_FALSE(logging(3));
+    EXPECT_TRUE(LOGGING(2));
+
+    // The first matching spec is used.
+    Log::addDebugSpec("log_test:4,other:5");
+    EXPECT_FALSE(logging(3));
+    EXPECT_EQ(LOGGING(2), LOGGING_FEATURE(__FILE__, 2));
+    EXPECT_EQ(LOGGING(3), LOGGING_FEATURE(__FILE__, 3));
+
+    // ... and when they are replaced.
+    Log::setDebugSpecs({});
+    EXPECT_FALSE(logging(1));
+}
+
+}  // namespace P4::Test
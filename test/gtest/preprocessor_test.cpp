@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2025 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "frontends/common/preprocessor.h"
+
+#include <gtest/gtest.h>
+
+#include "frontends/common/parser_options.h"
+#include "lib/error.h"
+#include "test/gtest/helpers.h"
+
+namespace P4::Test {
+
+class Preprocessor : public P4CTest {
+ protected:
+    /// @return the output of the preprocessor for @p text, without its first line marker.
+    static std::string preprocess(std::string_view text, std::vector<std::string> defines = {}) {
+        P4::Preprocessor preprocessor({p4includePath});
+        for (auto &define : defines) preprocessor.define(define);
+        auto output = preprocessor.preprocess("test.p4", text);
+        std::string_view marker = "# 1 \"test.p4\"\n";
+        EXPECT_EQ(output.substr(0, marker.size()), marker);
+        return output.substr(marker.size());
+    }
+};
+
+TEST_F(Preprocessor, ObjectLikeMacros) {
+    EXPECT_EQ(preprocess("#define W 8\nbit<W> x;\n"), "\nbit<8> x;\n");
+    EXPECT_EQ(preprocess("#define A B\n#define B A\nA B\n"), "\n\nA B\n");
+    EXPECT_EQ(preprocess("#define M -\nint x = -M 1;\n"), "\nint x = - - 1;\n");
+    EXPECT_EQ(preprocess("W __LINE__ __FILE__\n", {"W=16"}), "16 1 \"test.p4\"\n");
+}
+
+TEST_F(Preprocessor, FunctionLikeMacros) {
+    EXPECT_EQ(preprocess("#define ADD(a, b) ((a) + (b))\nADD(1, ADD(2, 3)) ADD\n"),
+              "\n((1) + (((2) + (3)))) ADD\n");
+    EXPECT_EQ(preprocess("#define STR(x) #x\nSTR(a \"b\" c)\n"), "\n\"a \\\"b\\\" c\"\n");
+    EXPECT_EQ(preprocess("#define CAT(a, b) a ## b\nCAT(x, 1) CAT(, y)\n"), "\nx1 y\n");
+    EXPECT_EQ(preprocess("#define LOG(f, ...) log(f, ## __VA_ARGS__)\nLOG(1) LOG(1, 2)\n"),
+              "\nlog(1) log(1,2)\n");
+    // Arguments that span lines keep the following lines in place
+    EXPECT_EQ(preprocess("#define ADD(a, b) a + b\nADD(1,\n    2)\nx\n"), "\n1 + 2\n\nx\n");
+}
+
+TEST_F(Preprocessor, Conditionals) {
+    EXPECT_EQ(preprocess("#if defined(A) && (1 << 3) == 8\na\n#elif 0x10 / 4 == 4\nb\n#else\n"
+                         "c\n#endif\n"),
+              "\n\n\nb\n\n\n\n");
+    EXPECT_EQ(preprocess("#ifdef A\na\n#endif\n#ifndef A\nb\n#endif\n", {"A"}), "\na\n\n\n\n\n");
+    EXPECT_EQ(preprocess("#if 0\n#error skipped\n#if 1\n#endif\n#endif\n"), "\n\n\n\n\n");
+    EXPECT_EQ(errorCount(), 0u);
+}
+
+TEST_F(Preprocessor, Errors) {
+    preprocess("#if 1 +\n#endif\n");
+    EXPECT_EQ(errorCount(), 1u);
+    preprocess("#define F(a, b) a\nF(1)\n");
+    EXPECT_EQ(errorCount(), 2u);
+    preprocess("#include \"missing.p4\"\n");
+    EXPECT_EQ(errorCount(), 3u);
+    preprocess("#if 1\n");
+    EXPECT_EQ(errorCount(), 4u);
+}
+
+TEST_F(Preprocessor, Include) {
+    auto output = preprocess("#include <core.p4>\n#include <core.p4>\nx\n");
+    auto core = (p4includePath / "core.p4").string();
+    auto marker = "# 1 \"" + core + "\" 1\n";
+    ASSERT_NE(output.find(marker), std::string::npos);
+    // core.p4 is included again, as it has no #pragma once
+    EXPECT_NE(output.find(marker, output.find(marker) + 1), std::string::npos);
+    EXPECT_TRUE(output.ends_with("# 3 \"test.p4\" 2\nx\n"));
+    EXPECT_EQ(errorCount(), 0u);
+}
+
+}  // namespace P4::Test
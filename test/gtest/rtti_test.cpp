@@ -62,6 +62,35 @@ TEST(RTTI, Is) {
     EXPECT_FALSE(v2->is<IR::IndexedVector<IR::Parameter>>());
 }
 
+TEST(RTTI, Interval) {
+    IR::Node *c = new IR::Constant(2);
+    IR::Node *add = new IR::Add(c->to<IR::Constant>(), c->to<IR::Constant>());
+    IR::Node *decl = new IR::NamedExpression("foo", add->to<IR::Expression>());
+
+    // Decided by the typeid intervals of the targets
+    EXPECT_TRUE(c->is<IR::Node>());
+    EXPECT_TRUE(add->is<IR::Operation_Binary>());
+    EXPECT_FALSE(add->is<IR::Operation_Unary>());
+    EXPECT_FALSE(c->is<IR::Type>());
+    EXPECT_EQ(add->to<IR::Operation_Relation>(), nullptr);
+    EXPECT_EQ(decl->to<IR::Declaration>(), dynamic_cast<IR::Declaration *>(decl));
+
+    // Outside of the tree of generated classes, or interfaces
+    IR::Node *v = new IR::Vector<IR::Type>();
+    EXPECT_TRUE(v->is<IR::Node>());
+    EXPECT_EQ(v->to<IR::Node>(), v);
+    EXPECT_FALSE(v->is<IR::Type>());
+    EXPECT_TRUE(decl->is<IR::IDeclaration>());
+    EXPECT_FALSE(c->is<IR::IDeclaration>());
+
+    // Agrees with the traversal of the class hierarchy
+    for (const IR::Node *n : {c, add, decl, v}) {
+        EXPECT_EQ(n->is<IR::Expression>(), n->isA(RTTI::TypeInfo<IR::Expression>::id()));
+        EXPECT_EQ(n->is<IR::Literal>(), n->isA(RTTI::TypeInfo<IR::Literal>::id()));
+        EXPECT_EQ(n->is<IR::Declaration>(), n->isA(RTTI::TypeInfo<IR::Declaration>::id()));
+    }
+}
+
 TEST(RTTI, Casts) {
     auto *c = new IR::Constant(2);
     IR::Expression *e1 = new IR::Add(c, c);
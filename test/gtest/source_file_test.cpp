@@ -69,6 +69,8 @@ TEST(UtilSourceFile, InputSources) {
 
 TEST(UtilSourceFile, SourceInfo) {
     Util::InputSources sources;
+    sources.appendText("First line\n");
+    sources.appendText("Second line\n");
 
     SourcePosition t1_s(1, 1);
     SourcePosition t1_e(1, 5);
@@ -88,4 +90,25 @@ TEST(UtilSourceFile, SourceInfo) {
     EXPECT_FALSE(invalid.isValid());
 }
 
+TEST(UtilSourceFile, Comments) {
+    Util::InputSources sources;
+    sources.appendText("x ");
+    SourcePosition start = sources.getCurrentPosition();
+    sources.appendText("// one");
+    sources.addComment(SourceInfo(&sources, start, sources.getCurrentPosition()), true);
+    sources.appendText("\n");
+    sources.appendText("/*");
+    start = sources.getCurrentPosition();
+    sources.appendText(" two\n */");
+    sources.addComment(SourceInfo(&sources, start, sources.getCurrentPosition()), false);
+
+    const auto &comments = sources.getAllComments();
+    ASSERT_EQ(2u, comments.size());
+    EXPECT_EQ("// one", comments[0]->toString());
+    EXPECT_EQ("(1:2)-(1:8)", comments[0]->getSourceInfo().toString());
+    EXPECT_EQ("/* two\n */", comments[1]->toString());
+    EXPECT_EQ("(2:2)-(3:3)", comments[1]->getSourceInfo().toString());
+    EXPECT_EQ(&comments, &sources.getAllComments());
+}
+
 }  // namespace P4::Util
@@ -130,6 +130,30 @@ void IrDefinitions::toposort() {
     elements = std::move(sorted);
 }
 
+// Number the non-interface classes in preorder of the tree of their concrete parents, rooted
+// at Node, so that the typeids of a class and of its descendants form an interval and
+// is<T> / to<T> are range checks.  Interfaces and nested classes are numbered after them.
+void IrDefinitions::assignTypeIds() {
+    std::map<const IrClass *, std::vector<IrClass *>> children;
+    for (auto *cls : *getClasses())
+        if (cls->kind != NodeKind::Interface && cls->kind != NodeKind::Nested)
+            children[cls->getParent()].push_back(cls);
+
+    typeIdOrder.clear();
+    auto visit = [&](const auto &self, IrClass *cls) -> void {
+        if (cls != IrClass::nodeClass()) typeIdOrder.push_back(cls);
+        cls->lastInTree = cls;
+        for (auto *child : children[cls]) {
+            self(self, child);
+            cls->lastInTree = child->lastInTree;
+        }
+    };
+    visit(visit, IrClass::nodeClass());
+
+    for (auto *cls : *getClasses())
+        if (!cls->lastInTree) typeIdOrder.push_back(cls);
+}
+
 Util::Enumerator<IrClass *> *IrDefinitions::getClasses() const {
     return Util::enumerate(elements)->as<IrClass *>()->where(
         [](IrClass *e) { return e != nullptr; });
@@ -266,9 +290,7 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
 
     t << std::endl;
 
-    // Emit node kinds
-    // TODO: Probably it would make sense to topo-sort the IDs to optimize the
-    // comparison trees generated by a compiler
+    // Emit node kinds, in the order of IrDefinitions::assignTypeIds
     t << "enum class NodeKind : RTTI::TypeId {\n"
       << "  Auto = 0,\n"
       << "  INode = 1,\n"
@@ -276,7 +298,7 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
 
     unsigned nkId = 3;
     auto *irNamespace = IrNamespace::get(nullptr, "IR"_cs);
-    for (auto *cls : *getClasses())
+    for (auto *cls : typeIdOrder)
         t << "  " << cls->qualified_name(irNamespace).replace("::", "_") << " = " << nkId++
           << ",\n";
 
@@ -290,6 +312,11 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
       << "  IndexedVectorT = UINT64_C(2),\n"
       << "  Auto = UINT64_C(0xFF)\n"
       << "};\n"
+      << "/// Typeids of Node and of its subclasses generated from .def files\n"
+      << "inline constexpr RTTI::TypeIdInterval NodeKindTree{RTTI::TypeId(NodeKind::Node), "
+         "RTTI::TypeId(NodeKind::"
+      << IrClass::nodeClass()->lastInTree->qualified_name(irNamespace).replace("::", "_")
+      << ")};\n"
       << " inline bool operator==(RTTI::TypeId lhs, NodeKind rhs) { return lhs == "
          "RTTI::TypeId(rhs); }\n"
       << " inline bool operator==(NodeKind lhs, RTTI::TypeId rhs) { return RTTI::TypeId(lhs) == "
@@ -480,7 +507,15 @@ void IrClass::generate_hdr(std::ostream &out) const {
             << name << ")" << std::endl;
 
     auto *irNamespace = IrNamespace::get(nullptr, "IR"_cs);
-    if (kind != NodeKind::Nested) {
+    if (lastInTree) {
+        out << indent << "DECLARE_TYPEINFO_WITH_TYPEID_INTERVAL(" << name
+            << ", NodeKind::" << qualified_name(irNamespace).replace("::", "_")
+            << ", NodeKind::" << lastInTree->qualified_name(irNamespace).replace("::", "_")
+            << ", NodeKindTree";
+        if (!concreteParent) out << ", Node";
+        for (const auto *p : parentClasses) out << ", " << p->qualified_name(containedIn);
+        out << ");" << std::endl;
+    } else if (kind != NodeKind::Nested) {
         out << indent << "DECLARE_TYPEINFO_WITH_TYPEID(" << name
             << ", NodeKind::" << qualified_name(irNamespace).replace("::", "_");
         if (!concreteParent) out << ", " << (kind != NodeKind::Interface ? "Node" : "INode");
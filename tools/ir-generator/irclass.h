@@ -267,6 +267,9 @@ class IrClass : public IrElement {
     std::vector<const IrClass *> parentClasses;
     std::vector<const Type *> parents;
     const IrClass *concreteParent;
+    /// Last descendant in preorder of the tree of Node subclasses (see
+    /// IrDefinitions::assignTypeIds), nullptr if this class is not in the tree.
+    const IrClass *lastInTree = nullptr;
 
     // each argument together with the class that has to receive it
     typedef std::vector<std::pair<const IrField *, const IrClass *>> ctor_args_t;
@@ -371,11 +374,14 @@ class IrEnumType : public IrElement {
 
 class IrDefinitions {
     std::vector<IrElement *> elements;
+    /// Classes in the order of their NodeKind typeids.
+    std::vector<const IrClass *> typeIdOrder;
     Util::Enumerator<IrClass *> *getClasses() const;
 
  public:
     explicit IrDefinitions(std::vector<IrElement *> classes) : elements(classes) {}
     void toposort();
+    void assignTypeIds();
     void resolve() {
         IrClass::nodeClass()->resolve();
         IrClass::vectorClass()->resolve();
@@ -385,6 +391,7 @@ class IrDefinitions {
         IrClass::indexedVectorClass()->resolve();
         for (auto cls : *getClasses()) cls->resolve();
         toposort();
+        assignTypeIds();
     }
     void generate(std::ostream &t, std::ostream &out, std::ostream &impl) const;
 };